@@ -7,13 +7,13 @@
     APIs: gl=3.3
     Profile: core
     Extensions:
-        GL_ARB_debug_output, GL_EXT_texture_compression_s3tc, GL_KHR_debug
+        GL_ARB_buffer_storage, GL_ARB_debug_output, GL_EXT_texture_compression_s3tc, GL_KHR_debug
     Loader: No
 
     Commandline:
-        --profile="core" --api="gl=3.3" --generator="c-debug" --spec="gl" --no-loader --extensions="GL_ARB_debug_output,GL_EXT_texture_compression_s3tc,GL_KHR_debug"
+        --profile="core" --api="gl=3.3" --generator="c-debug" --spec="gl" --no-loader --extensions="GL_ARB_buffer_storage,GL_ARB_debug_output,GL_EXT_texture_compression_s3tc,GL_KHR_debug"
     Online:
-        http://glad.dav1d.de/#profile=core&language=c-debug&specification=gl&api=gl%3D3.3&extensions=GL_ARB_debug_output&extensions=GL_EXT_texture_compression_s3tc&extensions=GL_KHR_debug
+        http://glad.dav1d.de/#profile=core&language=c-debug&specification=gl&api=gl%3D3.3&extensions=GL_ARB_buffer_storage&extensions=GL_ARB_debug_output&extensions=GL_EXT_texture_compression_s3tc&extensions=GL_KHR_debug
 */
 
 
@@ -2529,6 +2529,13 @@ GLAPI PFNGLSECONDARYCOLORP3UIVPROC glad_glSecondaryColorP3uiv;
 GLAPI PFNGLSECONDARYCOLORP3UIVPROC glad_debug_glSecondaryColorP3uiv;
 #define glSecondaryColorP3uiv glad_debug_glSecondaryColorP3uiv
 #endif
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#define GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT 0x00004000
+#define GL_BUFFER_IMMUTABLE_STORAGE 0x821F
+#define GL_BUFFER_STORAGE_FLAGS 0x8220
 #define GL_DEBUG_OUTPUT_SYNCHRONOUS_ARB 0x8242
 #define GL_DEBUG_NEXT_LOGGED_MESSAGE_LENGTH_ARB 0x8243
 #define GL_DEBUG_CALLBACK_FUNCTION_ARB 0x8244
@@ -2636,6 +2643,14 @@ GLAPI PFNGLSECONDARYCOLORP3UIVPROC glad_debug_glSecondaryColorP3uiv;
 #define GL_STACK_OVERFLOW_KHR 0x0503
 #define GL_STACK_UNDERFLOW_KHR 0x0504
 #define GL_DISPLAY_LIST 0x82E7
+#ifndef GL_ARB_buffer_storage
+#define GL_ARB_buffer_storage 1
+GLAPI int GLAD_GL_ARB_buffer_storage;
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+GLAPI PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+GLAPI PFNGLBUFFERSTORAGEPROC glad_debug_glBufferStorage;
+#define glBufferStorage glad_debug_glBufferStorage
+#endif
 #ifndef GL_ARB_debug_output
 #define GL_ARB_debug_output 1
 GLAPI int GLAD_GL_ARB_debug_output;
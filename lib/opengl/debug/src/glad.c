@@ -7,13 +7,13 @@
     APIs: gl=3.3
     Profile: core
     Extensions:
-        GL_ARB_debug_output, GL_EXT_texture_compression_s3tc, GL_KHR_debug
+        GL_ARB_buffer_storage, GL_ARB_debug_output, GL_EXT_texture_compression_s3tc, GL_KHR_debug
     Loader: No
 
     Commandline:
-        --profile="core" --api="gl=3.3" --generator="c-debug" --spec="gl" --no-loader --extensions="GL_ARB_debug_output,GL_EXT_texture_compression_s3tc,GL_KHR_debug"
+        --profile="core" --api="gl=3.3" --generator="c-debug" --spec="gl" --no-loader --extensions="GL_ARB_buffer_storage,GL_ARB_debug_output,GL_EXT_texture_compression_s3tc,GL_KHR_debug"
     Online:
-        http://glad.dav1d.de/#profile=core&language=c-debug&specification=gl&api=gl%3D3.3&extensions=GL_ARB_debug_output&extensions=GL_EXT_texture_compression_s3tc&extensions=GL_KHR_debug
+        http://glad.dav1d.de/#profile=core&language=c-debug&specification=gl&api=gl%3D3.3&extensions=GL_ARB_buffer_storage&extensions=GL_ARB_debug_output&extensions=GL_EXT_texture_compression_s3tc&extensions=GL_KHR_debug
 */
 
 #include <stdio.h>
@@ -3163,6 +3163,15 @@ void APIENTRY glad_debug_impl_glFrontFace(GLenum arg0) {
 PFNGLFRONTFACEPROC glad_debug_glFrontFace = glad_debug_impl_glFrontFace;
 int GLAD_GL_KHR_debug;
 int GLAD_GL_EXT_texture_compression_s3tc;
+int GLAD_GL_ARB_buffer_storage;
+PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+void APIENTRY glad_debug_impl_glBufferStorage(GLenum arg0, GLsizeiptr arg1, const void* arg2, GLbitfield arg3) {    
+    _pre_call_callback("glBufferStorage", (void*)glBufferStorage, 4, arg0, arg1, arg2, arg3);
+     glad_glBufferStorage(arg0, arg1, arg2, arg3);
+    _post_call_callback("glBufferStorage", (void*)glBufferStorage, 4, arg0, arg1, arg2, arg3);
+    
+}
+PFNGLBUFFERSTORAGEPROC glad_debug_glBufferStorage = glad_debug_impl_glBufferStorage;
 int GLAD_GL_ARB_debug_output;
 PFNGLDEBUGMESSAGECONTROLARBPROC glad_glDebugMessageControlARB;
 void APIENTRY glad_debug_impl_glDebugMessageControlARB(GLenum arg0, GLenum arg1, GLenum arg2, GLsizei arg3, const GLuint* arg4, GLboolean arg5) {    
@@ -3788,6 +3797,10 @@ static void load_GL_VERSION_3_3(GLADloadproc load) {
 	glad_glSecondaryColorP3ui = (PFNGLSECONDARYCOLORP3UIPROC)load("glSecondaryColorP3ui");
 	glad_glSecondaryColorP3uiv = (PFNGLSECONDARYCOLORP3UIVPROC)load("glSecondaryColorP3uiv");
 }
+static void load_GL_ARB_buffer_storage(GLADloadproc load) {
+	if(!GLAD_GL_ARB_buffer_storage) return;
+	glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+}
 static void load_GL_ARB_debug_output(GLADloadproc load) {
 	if(!GLAD_GL_ARB_debug_output) return;
 	glad_glDebugMessageControlARB = (PFNGLDEBUGMESSAGECONTROLARBPROC)load("glDebugMessageControlARB");
@@ -3822,6 +3835,7 @@ static void load_GL_KHR_debug(GLADloadproc load) {
 }
 static int find_extensionsGL(void) {
 	if (!get_exts()) return 0;
+	GLAD_GL_ARB_buffer_storage = has_ext("GL_ARB_buffer_storage");
 	GLAD_GL_ARB_debug_output = has_ext("GL_ARB_debug_output");
 	GLAD_GL_EXT_texture_compression_s3tc = has_ext("GL_EXT_texture_compression_s3tc");
 	GLAD_GL_KHR_debug = has_ext("GL_KHR_debug");
@@ -3903,6 +3917,7 @@ int gladLoadGLLoader(GLADloadproc load) {
 	load_GL_VERSION_3_3(load);
 
 	if (!find_extensionsGL()) return 0;
+	load_GL_ARB_buffer_storage(load);
 	load_GL_ARB_debug_output(load);
 	load_GL_KHR_debug(load);
 	return GLVersion.major != 0 || GLVersion.minor != 0;
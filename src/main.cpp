@@ -4,9 +4,13 @@
 #include <SDL.h>
 
 #include <memory>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
 #include <util/Timing.hpp>
 #include <renderer/Renderer.hpp>
 #include <renderer/opengl/GL3Renderer.hpp>
+#include <renderer/null/NullRenderer.hpp>
 #include <util/DefaultFileLoader.hpp>
 #include <renderer/Exceptions.hpp>
 #include "test/Application.hpp"
@@ -19,6 +23,10 @@ namespace {
 
     SDL_Window *window = nullptr;
 
+    // In headless mode the null renderer is used and a fixed number of frames is rendered without a window
+    bool headless = false;
+    uint32_t headless_frames = 1000;
+
     void render() {
         app->render(renderer.get());
     }
@@ -60,7 +68,53 @@ namespace {
         }
     }
 
+    void run_headless() {
+        auto nullRenderer = static_cast<NullRenderer*>(renderer.get());
+
+        // Don't count the uploads of the initialization
+        nullRenderer->resetStatistics();
+
+        auto freq = SDL_GetPerformanceFrequency();
+        auto begin = SDL_GetPerformanceCounter();
+
+        for (uint32_t i = 0; i < headless_frames; ++i) {
+            timing->tick();
+
+            render();
+        }
+
+        auto end = SDL_GetPerformanceCounter();
+
+        printf("Rendered %u frames in %fms (%fms per frame)\n", headless_frames, (end - begin) * 1000.0 / freq,
+               (end - begin) * 1000.0 / freq / headless_frames);
+        nullRenderer->printStatistics();
+    }
+
+    bool init_headless() {
+        renderer.reset(new NullRenderer());
+
+        RendererSettings settings;
+        settings.resolution = glm::uvec2(1680, 1050);
+        settings.vertical_sync = false;
+        settings.msaa_samples = 0;
+        renderer->getSettingsManager()->changeSettings(settings);
+
+        SDL_InitSubSystem(SDL_INIT_TIMER);
+
+        renderer->initialize(nullptr);
+
+        timing.reset(new Timing());
+
+        app.reset(new Application(renderer.get(), timing.get(), nullptr));
+
+        return true;
+    }
+
     bool init() {
+        if (headless) {
+            return init_headless();
+        }
+
         renderer.reset(new GL3Renderer(std::unique_ptr<FileLoader>(new DefaultFileLoader())));
         try {
             RendererSettings settings;
@@ -99,7 +153,9 @@ namespace {
 
         renderer->deinitialize();
 
-        SDL_DestroyWindow(window);
+        if (window != nullptr) {
+            SDL_DestroyWindow(window);
+        }
         SDL_QuitSubSystem(SDL_INIT_VIDEO | SDL_INIT_TIMER);
         window = nullptr;
 
@@ -111,13 +167,28 @@ namespace {
 #undef main
 
 int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--headless")) {
+            headless = true;
+
+            if (i + 1 < argc && isdigit(argv[i + 1][0])) {
+                headless_frames = (uint32_t) strtoul(argv[i + 1], nullptr, 10);
+                ++i;
+            }
+        }
+    }
+
     SDL_Init(0);
 
     if (!init()) {
         return 1;
     }
 
-    run_mainloop();
+    if (headless) {
+        run_headless();
+    } else {
+        run_mainloop();
+    }
 
     deinit();
 
@@ -3,6 +3,12 @@
 
 #include "AssimpModelConverter.hpp"
 #include "Model.hpp"
+#include "MeshOptimizer.hpp"
+#include "ModelCompression.hpp"
+#include "ModelFormat.hpp"
+
+#include <util/HashUtil.hpp>
+#include <util/MemoryMappedFile.hpp>
 
 #include <assimp/postprocess.h>
 #include <assimp/Logger.hpp>
@@ -10,6 +16,9 @@
 #include <sstream>
 #include <unordered_map>
 #include <fstream>
+#include <limits>
+#include <cstdio>
+#include <cstring>
 #include <jansson.h>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -21,7 +30,14 @@ uint32_t DEFAULT_POST_PROCESSING_STEPS =
         | aiProcess_FindDegenerates | aiProcess_FindInvalidData | aiProcess_GenUVCoords | aiProcess_TransformUVCoords
         | aiProcess_FindInstances | aiProcess_OptimizeMeshes;
 
-const int SUPPORTED_VERSION = 1;
+// Files with packed vertex data use version 2 since older readers would interpret the data as float vertices. Files
+// with compressed chunks use COMPRESSED_CHUNKS_VERSION.
+const int FLOAT_VERTICES_VERSION = 1;
+const int PACKED_VERTICES_VERSION = 2;
+
+// Part of the source hash. Must be incremented whenever the converter produces different output for the same input so
+// that cached conversions are redone.
+const uint32_t CONVERTER_VERSION = 1;
 
 bool loggerCreated = false;
 void createAILogger() {
@@ -41,15 +57,11 @@ void createAILogger() {
     Assimp::DefaultLogger::get()->info("this is my info-call");
 }
 
-uint16_t process_index(uint32_t index, std::pair<uint32_t, uint32_t>& min_max_pair) {
-    if (index > std::numeric_limits<uint16_t>::max()) {
-        throw std::runtime_error("An index had a too large value!");
-    }
-
+uint32_t process_index(uint32_t index, std::pair<uint32_t, uint32_t>& min_max_pair) {
     min_max_pair.first = std::min(index, min_max_pair.first);
     min_max_pair.second = std::max(index, min_max_pair.second);
 
-    return static_cast<uint16_t>(index);
+    return index;
 }
 
 std::string cleanup_path(const char* path) {
@@ -103,23 +115,64 @@ ExportMaterial convertAssimpMaterial(aiMaterial* material) {
     return ret_val;
 }
 
-constexpr uint32_t make_id(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
-    return ((uint32_t) ((d << 24) | (c << 16) | (b << 8) | a));
-}
+// Files with compressed chunks use the extended chunk header for every chunk. A chunk is only stored compressed if that
+// makes it smaller.
+void write_chunk(std::ofstream& out, uint32_t id, const void* data, uint64_t size, bool compress) {
+    if (!compress) {
+        out.write(reinterpret_cast<char*>(&id), sizeof(id));
+        out.write(reinterpret_cast<char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(data), (std::streamsize) size);
+        return;
+    }
+
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    auto compression = ChunkCompression::Indices;
+    std::vector<uint8_t> compressed;
+    if (id == CHUNK_INDEX_DATA) {
+        compressed = model_compression::compressIndices(bytes, (size_t) size, sizeof(uint16_t));
+    } else if (id == CHUNK_INDEX_DATA_32) {
+        compressed = model_compression::compressIndices(bytes, (size_t) size, sizeof(uint32_t));
+    } else {
+        compression = ChunkCompression::LZ;
+        compressed = model_compression::compressLZ(bytes, (size_t) size);
+    }
+
+    const void* stored_data = compressed.data();
+    uint64_t stored_size = compressed.size();
+    // The source hash is checked without decompressing it
+    if (stored_size >= size || id == CHUNK_SOURCE_HASH) {
+        compression = ChunkCompression::None;
+        stored_data = data;
+        stored_size = size;
+    }
+
+    char name[5] = {};
+    std::memcpy(name, &id, sizeof(id));
+    printf("Chunk %s: %llu -> %llu bytes (%.1f%%)\n",
+           name,
+           (unsigned long long) size,
+           (unsigned long long) stored_size,
+           size == 0 ? 100.0 : stored_size * 100.0 / size);
 
-void write_chunk(std::ofstream& out, uint32_t id, void* data, uint64_t size) {
+    auto compression_value = static_cast<uint32_t>(compression);
     out.write(reinterpret_cast<char*>(&id), sizeof(id));
+    out.write(reinterpret_cast<char*>(&compression_value), sizeof(compression_value));
+    out.write(reinterpret_cast<char*>(&stored_size), sizeof(stored_size));
     out.write(reinterpret_cast<char*>(&size), sizeof(size));
-    out.write(reinterpret_cast<char*>(data), (std::streamsize) size);
+    out.write(reinterpret_cast<const char*>(stored_data), (std::streamsize) stored_size);
 }
 
-json_t* serializeMatrix(const aiMatrix4x4& mat) {
-    json_t* mat_node = json_array();
-
+glm::mat4 convertMatrix(const aiMatrix4x4& mat) {
     aiMatrix4x4 workMat = mat;
     workMat.Transpose(); // Row-major -> Column-major
 
-    auto transform = glm::make_mat4x4(workMat[0]); // I hope this works...
+    return glm::make_mat4x4(workMat[0]);
+}
+
+json_t* serializeMatrix(const aiMatrix4x4& mat) {
+    json_t* mat_node = json_array();
+
+    auto transform = convertMatrix(mat);
 
     for (int i = 0; i < transform.length(); ++i) {
         auto column = transform[i];
@@ -149,13 +202,86 @@ bool hasMesh(aiNode* node) {
 
     return false;
 }
+
+// Stores every distinct string once, references are byte offsets of the null-terminated strings
+class StringTable {
+    std::vector<char> _data;
+    std::unordered_map<std::string, StringReference> _offsets;
+ public:
+    StringReference add(const std::string& str) {
+        auto iter = _offsets.find(str);
+        if (iter != _offsets.end()) {
+            return iter->second;
+        }
+
+        auto offset = static_cast<StringReference>(_data.size());
+        _data.insert(_data.end(), str.begin(), str.end());
+        _data.push_back('\0');
+
+        _offsets.insert(std::make_pair(str, offset));
+        return offset;
+    }
+
+    std::vector<char>& getData() {
+        return _data;
+    }
+};
+
+// Parents are added before their children so the reader can rebuild the hierarchy in a single pass
+void flattenNodeHierarchy(aiNode* node,
+                          int32_t parent,
+                          const std::unordered_map<uint32_t, size_t>& meshMapping,
+                          StringTable& strings,
+                          std::vector<FileNode>& nodes,
+                          std::vector<uint32_t>& meshReferences) {
+    FileNode fileNode;
+    fileNode.transform = convertMatrix(node->mTransformation);
+    fileNode.name = strings.add(node->mName.C_Str());
+    fileNode.parent = parent;
+    fileNode.first_mesh = static_cast<uint32_t>(meshReferences.size());
+    fileNode.mesh_count = node->mNumMeshes;
+
+    for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
+        auto iter = meshMapping.find(node->mMeshes[i]);
+        if (iter == meshMapping.end()) {
+            throw std::runtime_error("Inconsistent data structure detected! Mesh mapping is not consistent!");
+        }
+
+        meshReferences.push_back(static_cast<uint32_t>(iter->second));
+    }
+
+    auto index = static_cast<int32_t>(nodes.size());
+    nodes.push_back(fileNode);
+
+    for (uint32_t i = 0; i < node->mNumChildren; ++i) {
+        auto child = node->mChildren[i];
+
+        if (hasMesh(child)) {
+            // Only include nodes that have meshes or have children that have meshes
+            flattenNodeHierarchy(child, index, meshMapping, strings, nodes, meshReferences);
+        }
+    }
 }
 
-AssimpModelConverter::AssimpModelConverter() : _scene(nullptr) {
-    createAILogger();
+// Array chunks start with the number of elements followed by the elements
+template<typename T>
+void write_array_chunk(std::ofstream& out, uint32_t id, std::vector<T>& elements, bool compress) {
+    auto count = static_cast<uint32_t>(elements.size());
+
+    std::vector<uint8_t> data(sizeof(count) + elements.size() * sizeof(T));
+    std::memcpy(data.data(), &count, sizeof(count));
+    if (!elements.empty()) {
+        std::memcpy(data.data() + sizeof(count), elements.data(), elements.size() * sizeof(T));
+    }
+
+    write_chunk(out, id, data.data(), data.size(), compress);
+}
+}
 
-    // Indices are 16-bit, make sure that the "split large meshes" step enforces that
-    _importer.SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT, 65536);
+AssimpModelConverter::AssimpModelConverter()
+    : _scene(nullptr), _vertexFormat(ModelVertexFormat::Float), _optimizeMeshes(true), _writeJsonMetadata(false),
+      _compressChunks(false), _useConversionCache(true) {
+    createAILogger();
 
     // Colors are unused, remove them during import
     _importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_COLORS);
@@ -173,23 +299,56 @@ void AssimpModelConverter::convertModel(const std::string& input_file,
     _materialMapping.clear();
     _meshMapping.clear();
 
-    _scene = _importer.ReadFile(input_file.c_str(), DEFAULT_POST_PROCESSING_STEPS);
-
     std::ostringstream oss;
     oss << output_directory << "/" << output_name << ".fom";
+    auto model_file = oss.str();
 
+    oss.str("");
+    oss << output_directory << "/" << output_name << ".json";
+    auto json_file = oss.str();
+
+    uint64_t source_hash;
+    if (!computeSourceHash(input_file, source_hash)) {
+        fprintf(stderr, "Failed to read source file %s!\n", input_file.c_str());
+        return;
+    }
+
+    if (_useConversionCache && isUpToDate(model_file, json_file, source_hash)) {
+        printf("%s is up to date, skipping conversion.\n", model_file.c_str());
+        return;
+    }
+
+    _scene = _importer.ReadFile(input_file.c_str(), DEFAULT_POST_PROCESSING_STEPS);
+    if (_scene == nullptr) {
+        fprintf(stderr, "Failed to import %s: %s\n", input_file.c_str(), _importer.GetErrorString());
+        return;
+    }
+
+    // The file is written under a temporary name first so an interrupted conversion never leaves a file behind that
+    // looks up to date
+    auto temp_file = model_file + ".tmp";
     try {
-        write_mesh_data(oss.str());
+        write_mesh_data(temp_file, source_hash);
     } catch (const std::runtime_error& e) {
         fprintf(stderr, "Error while writing mesh data: %s\n", e.what());
+        std::remove(temp_file.c_str());
+        return;
+    }
+
+    // Renaming does not replace existing files on every platform
+    std::remove(model_file.c_str());
+    if (std::rename(temp_file.c_str(), model_file.c_str()) != 0) {
+        fprintf(stderr, "Failed to move %s to %s!\n", temp_file.c_str(), model_file.c_str());
+        return;
+    }
+
+    if (!_writeJsonMetadata) {
         return;
     }
 
-    oss.str("");
-    oss << output_directory << "/" << output_name << ".json";
     try {
         auto json_root = serializeMetadata();
-        FILE* f = std::fopen(oss.str().c_str(), "wb");
+        FILE* f = std::fopen(json_file.c_str(), "wb");
         json_dumpf(json_root, f, JSON_INDENT(4) | JSON_ENSURE_ASCII);
         json_decref(json_root);
         std::fclose(f);
@@ -199,6 +358,122 @@ void AssimpModelConverter::convertModel(const std::string& input_file,
     }
 }
 
+void AssimpModelConverter::setVertexFormat(ModelVertexFormat format) {
+    _vertexFormat = format;
+}
+
+void AssimpModelConverter::setOptimizeMeshes(bool optimize) {
+    _optimizeMeshes = optimize;
+}
+
+void AssimpModelConverter::setWriteJsonMetadata(bool write) {
+    _writeJsonMetadata = write;
+}
+
+void AssimpModelConverter::setCompressChunks(bool compress) {
+    _compressChunks = compress;
+}
+
+void AssimpModelConverter::setUseConversionCache(bool use) {
+    _useConversionCache = use;
+}
+
+bool AssimpModelConverter::computeSourceHash(const std::string& input_file, uint64_t& hash) {
+    MemoryMappedFile source;
+    if (!source.open(input_file)) {
+        return false;
+    }
+
+    hash = hash_fnv1a(source.getData(), source.getSize());
+
+    // Everything else that changes the output of the conversion
+    auto post_processing = DEFAULT_POST_PROCESSING_STEPS;
+    auto converter_version = CONVERTER_VERSION;
+    auto vertex_format = static_cast<uint32_t>(_vertexFormat);
+    uint8_t flags = (_optimizeMeshes ? 1 : 0) | (_compressChunks ? 2 : 0);
+    hash = hash_fnv1a(&post_processing, sizeof(post_processing), hash);
+    hash = hash_fnv1a(&converter_version, sizeof(converter_version), hash);
+    hash = hash_fnv1a(&vertex_format, sizeof(vertex_format), hash);
+    hash = hash_fnv1a(&flags, sizeof(flags), hash);
+
+    return true;
+}
+
+bool AssimpModelConverter::isUpToDate(const std::string& model_file, const std::string& json_file, uint64_t hash) {
+    if (_writeJsonMetadata && !std::ifstream(json_file).good()) {
+        return false;
+    }
+
+    std::ifstream in(model_file, std::ios_base::in | std::ios_base::binary);
+    if (!in.good()) {
+        return false;
+    }
+
+    // The source hash is always the first chunk so only the beginning of the file is read
+    char identifier[8];
+    uint32_t version;
+    in.read(identifier, sizeof(identifier));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+    uint32_t chunk_type;
+    uint32_t compression = static_cast<uint32_t>(ChunkCompression::None);
+    uint64_t chunk_length;
+    in.read(reinterpret_cast<char*>(&chunk_type), sizeof(chunk_type));
+    if (version >= COMPRESSED_CHUNKS_VERSION) {
+        in.read(reinterpret_cast<char*>(&compression), sizeof(compression));
+    }
+    in.read(reinterpret_cast<char*>(&chunk_length), sizeof(chunk_length));
+    if (version >= COMPRESSED_CHUNKS_VERSION) {
+        uint64_t uncompressed_length;
+        in.read(reinterpret_cast<char*>(&uncompressed_length), sizeof(uncompressed_length));
+    }
+
+    uint64_t stored_hash;
+    in.read(reinterpret_cast<char*>(&stored_hash), sizeof(stored_hash));
+
+    if (!in.good() || std::strncmp(identifier, "FSOMODEL", sizeof(identifier)) != 0) {
+        return false;
+    }
+    if (chunk_type != CHUNK_SOURCE_HASH || compression != static_cast<uint32_t>(ChunkCompression::None)
+        || chunk_length != sizeof(stored_hash)) {
+        return false;
+    }
+
+    return stored_hash == hash;
+}
+
+void AssimpModelConverter::optimizeMesh(const std::string& name,
+                                        std::vector<ModelVertexData>& vertices,
+                                        std::vector<uint32_t>& indices) {
+    auto vertexSize = getModelVertexSize(_vertexFormat);
+    auto before = mesh_optimizer::analyzeMesh(indices, vertices.size(), vertexSize);
+
+    auto clusters = mesh_optimizer::optimizeVertexCache(indices, vertices.size());
+
+    std::vector<glm::vec3> positions;
+    positions.reserve(vertices.size());
+    for (auto& vertex : vertices) {
+        positions.push_back(vertex.position);
+    }
+    mesh_optimizer::optimizeOverdraw(indices, positions, clusters);
+
+    // This has to be the last step since it changes the vertex indices
+    size_t usedVertices;
+    auto remap = mesh_optimizer::optimizeVertexFetch(indices, vertices.size(), usedVertices);
+    vertices = mesh_optimizer::remapVertices(vertices, remap, usedVertices);
+
+    auto after = mesh_optimizer::analyzeMesh(indices, vertices.size(), vertexSize);
+
+    printf("Optimized mesh '%s': ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, overfetch %.3f -> %.3f\n",
+           name.c_str(),
+           before.acmr,
+           after.acmr,
+           before.atvr,
+           after.atvr,
+           before.overfetch,
+           after.overfetch);
+}
+
 size_t AssimpModelConverter::getMaterialIndex(uint32_t aiIndex) {
     auto iter = _materialMapping.find(aiIndex);
     if (iter != _materialMapping.end()) {
@@ -214,9 +489,10 @@ size_t AssimpModelConverter::getMaterialIndex(uint32_t aiIndex) {
     return index;
 }
 
-void AssimpModelConverter::write_mesh_data(const std::string& output_file) {
+void AssimpModelConverter::write_mesh_data(const std::string& output_file, uint64_t source_hash) {
     std::vector<ModelVertexData> vertex_data;
-    std::vector<uint16_t> index_data;
+    std::vector<uint32_t> index_data;
+    uint32_t max_index = 0;
 
     uint32_t index_offset = 0;
     size_t index_begin = 0;
@@ -233,6 +509,8 @@ void AssimpModelConverter::write_mesh_data(const std::string& output_file) {
             throw std::runtime_error("Model needs to be textured!");
         }
 
+        std::vector<ModelVertexData> mesh_vertices;
+        mesh_vertices.reserve(mesh->mNumVertices);
         for (size_t vert = 0; vert < mesh->mNumVertices; ++vert) {
             auto& pos = mesh->mVertices[vert];
             auto& normal = mesh->mNormals[vert];
@@ -246,16 +524,28 @@ void AssimpModelConverter::write_mesh_data(const std::string& output_file) {
             data.tex_coord = glm::vec3(texCoord.x, texCoord.y, 0.f);
             data.tangent = glm::vec3(tangent.x, tangent.y, tangent.z);
             data.bitangent = glm::vec3(bitangent.x, bitangent.y, bitangent.z);
-            vertex_data.push_back(data);
+            mesh_vertices.push_back(data);
         }
 
-        std::pair<uint32_t, uint32_t> min_max_pair = std::make_pair(std::numeric_limits<uint32_t>::max(), 0);
+        std::vector<uint32_t> mesh_indices;
+        mesh_indices.reserve(mesh->mNumFaces * 3);
         for (size_t index = 0; index < mesh->mNumFaces; ++index) {
             auto& face = mesh->mFaces[index];
             assert(face.mNumIndices == 3);
-            index_data.push_back(process_index(face.mIndices[0], min_max_pair));
-            index_data.push_back(process_index(face.mIndices[1], min_max_pair));
-            index_data.push_back(process_index(face.mIndices[2], min_max_pair));
+            mesh_indices.push_back(face.mIndices[0]);
+            mesh_indices.push_back(face.mIndices[1]);
+            mesh_indices.push_back(face.mIndices[2]);
+        }
+
+        if (_optimizeMeshes) {
+            optimizeMesh(mesh->mName.C_Str(), mesh_vertices, mesh_indices);
+        }
+
+        vertex_data.insert(vertex_data.end(), mesh_vertices.begin(), mesh_vertices.end());
+
+        std::pair<uint32_t, uint32_t> min_max_pair = std::make_pair(std::numeric_limits<uint32_t>::max(), 0);
+        for (auto index : mesh_indices) {
+            index_data.push_back(process_index(index, min_max_pair));
         }
 
         ExportMeshData data;
@@ -263,17 +553,19 @@ void AssimpModelConverter::write_mesh_data(const std::string& output_file) {
         data.material_index = getMaterialIndex(mesh->mMaterialIndex);
 
         data.offset = index_begin;
-        data.count = mesh->mNumFaces * 3;
+        data.count = static_cast<uint32_t>(mesh_indices.size());
 
         data.base_index = index_offset;
         data.min_index = min_max_pair.first;
         data.max_index = min_max_pair.second;
 
+        max_index = std::max(max_index, data.max_index);
+
         _meshData.push_back(data);
         _meshMapping.insert(std::make_pair(i, _meshData.size() - 1));
 
-        index_offset += mesh->mNumVertices;
-        index_begin += mesh->mNumFaces * 3;
+        index_offset += static_cast<uint32_t>(mesh_vertices.size());
+        index_begin += mesh_indices.size();
     }
 
     std::ofstream outstream;
@@ -283,19 +575,117 @@ void AssimpModelConverter::write_mesh_data(const std::string& output_file) {
     }
 
     outstream.write("FSOMODEL", 8);
-    uint32_t version = SUPPORTED_VERSION;
+    uint32_t version = _vertexFormat == ModelVertexFormat::Packed ? PACKED_VERTICES_VERSION : FLOAT_VERTICES_VERSION;
+    if (_compressChunks) {
+        version = COMPRESSED_CHUNKS_VERSION;
+    }
     outstream.write(reinterpret_cast<const char*>(&version), sizeof(version));
 
+    // Must be the first chunk, see isUpToDate
+    write_chunk(outstream, CHUNK_SOURCE_HASH, &source_hash, sizeof(source_hash), _compressChunks);
+
+    // Write vertex format, this comes before the vertex data so the reader knows how to interpret it
+    auto vertex_format = static_cast<uint32_t>(_vertexFormat);
+    write_chunk(outstream, CHUNK_VERTEX_FORMAT, &vertex_format, sizeof(vertex_format), _compressChunks);
+
     // Write vertex data
-    write_chunk(outstream, make_id('V', 'D', 'A', 'T'), vertex_data.data(), vertex_data.size() * sizeof(vertex_data[0]));
+    if (_vertexFormat == ModelVertexFormat::Packed) {
+        std::vector<PackedModelVertexData> packed_data;
+        packed_data.reserve(vertex_data.size());
+        for (auto& vertex : vertex_data) {
+            packed_data.push_back(packModelVertex(vertex));
+        }
 
-    // Write index data
-    write_chunk(outstream, make_id('I', 'N', 'D', 'X'), index_data.data(), index_data.size() * sizeof(index_data[0]));
+        write_chunk(outstream,
+                    CHUNK_VERTEX_DATA,
+                    packed_data.data(),
+                    packed_data.size() * sizeof(packed_data[0]),
+                    _compressChunks);
+    } else {
+        write_chunk(outstream,
+                    CHUNK_VERTEX_DATA,
+                    vertex_data.data(),
+                    vertex_data.size() * sizeof(vertex_data[0]),
+                    _compressChunks);
+    }
+
+    // Write index data. The indices are relative to the base index of their mesh so 16-bit indices are enough unless a
+    // mesh has more than 65536 vertices.
+    if (max_index > std::numeric_limits<uint16_t>::max()) {
+        write_chunk(outstream,
+                    CHUNK_INDEX_DATA_32,
+                    index_data.data(),
+                    index_data.size() * sizeof(index_data[0]),
+                    _compressChunks);
+    } else {
+        std::vector<uint16_t> short_indices(index_data.begin(), index_data.end());
+        write_chunk(outstream,
+                    CHUNK_INDEX_DATA,
+                    short_indices.data(),
+                    short_indices.size() * sizeof(short_indices[0]),
+                    _compressChunks);
+    }
+
+    write_metadata(outstream);
 
     outstream.flush();
     outstream.close();
 }
 
+void AssimpModelConverter::write_metadata(std::ofstream& out) {
+    StringTable strings;
+
+    std::vector<FileMaterial> materials;
+    materials.reserve(_materials.size());
+    for (auto& mat : _materials) {
+        FileMaterial fileMaterial;
+        fileMaterial.name = strings.add(mat.name);
+        fileMaterial.diffuse_texture = strings.add(mat.diffuse_texture);
+        materials.push_back(fileMaterial);
+    }
+
+    std::vector<FileMesh> meshes;
+    meshes.reserve(_meshData.size());
+    for (auto& mesh : _meshData) {
+        FileMesh fileMesh;
+        fileMesh.offset = mesh.offset;
+        fileMesh.name = strings.add(mesh.name);
+        fileMesh.material_index = static_cast<uint32_t>(mesh.material_index);
+        fileMesh.count = mesh.count;
+        fileMesh.base_index = mesh.base_index;
+        fileMesh.min_index = mesh.min_index;
+        fileMesh.max_index = mesh.max_index;
+        meshes.push_back(fileMesh);
+    }
+
+    std::vector<FileNode> nodes;
+    std::vector<uint32_t> meshReferences;
+    flattenNodeHierarchy(_scene->mRootNode, NO_PARENT_NODE, _meshMapping, strings, nodes, meshReferences);
+
+    // The node chunk contains the node and mesh reference counts followed by the nodes and the mesh references
+    auto nodeCount = static_cast<uint32_t>(nodes.size());
+    auto referenceCount = static_cast<uint32_t>(meshReferences.size());
+    std::vector<uint8_t> nodeData(2 * sizeof(uint32_t) + nodes.size() * sizeof(FileNode)
+                                      + meshReferences.size() * sizeof(uint32_t));
+    auto nodePtr = nodeData.data();
+    std::memcpy(nodePtr, &nodeCount, sizeof(nodeCount));
+    nodePtr += sizeof(nodeCount);
+    std::memcpy(nodePtr, &referenceCount, sizeof(referenceCount));
+    nodePtr += sizeof(referenceCount);
+    std::memcpy(nodePtr, nodes.data(), nodes.size() * sizeof(FileNode));
+    nodePtr += nodes.size() * sizeof(FileNode);
+    if (!meshReferences.empty()) {
+        std::memcpy(nodePtr, meshReferences.data(), meshReferences.size() * sizeof(uint32_t));
+    }
+
+    // The string table is written first so the other chunks can be resolved as soon as they are read
+    auto& stringData = strings.getData();
+    write_chunk(out, CHUNK_STRINGS, stringData.data(), stringData.size(), _compressChunks);
+    write_array_chunk(out, CHUNK_MATERIALS, materials, _compressChunks);
+    write_array_chunk(out, CHUNK_MESHES, meshes, _compressChunks);
+    write_chunk(out, CHUNK_NODES, nodeData.data(), nodeData.size(), _compressChunks);
+}
+
 json_t* AssimpModelConverter::serializeMetadata() {
     json_t* root = json_object();
 
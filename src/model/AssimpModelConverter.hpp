@@ -7,6 +7,7 @@
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 
+#include <fstream>
 #include <unordered_map>
 #include <jansson.h>
 
@@ -39,7 +40,22 @@ class AssimpModelConverter {
     std::unordered_map<uint32_t, size_t> _materialMapping; // assimp -> _materials
     std::unordered_map<uint32_t, size_t> _meshMapping; // assimp -> _meshData
 
-    void write_mesh_data(const std::string& output_file);
+    ModelVertexFormat _vertexFormat;
+    bool _optimizeMeshes;
+    bool _writeJsonMetadata;
+    bool _compressChunks;
+    bool _useConversionCache;
+
+    void optimizeMesh(const std::string& name, std::vector<ModelVertexData>& vertices, std::vector<uint32_t>& indices);
+
+    // Hashes the source file together with everything else that affects the output
+    bool computeSourceHash(const std::string& input_file, uint64_t& hash);
+
+    bool isUpToDate(const std::string& model_file, const std::string& json_file, uint64_t hash);
+
+    void write_mesh_data(const std::string& output_file, uint64_t source_hash);
+
+    void write_metadata(std::ofstream& out);
 
     size_t getMaterialIndex(uint32_t aiIndex);
 
@@ -50,6 +66,25 @@ class AssimpModelConverter {
  public:
     AssimpModelConverter();
 
+    // The packed format is about 2.5 times smaller but older versions of the engine can't read it
+    void setVertexFormat(ModelVertexFormat format);
+
+    // Reorders the triangles and vertices of every mesh for the post-transform cache, overdraw and vertex fetch.
+    // Enabled by default.
+    void setOptimizeMeshes(bool optimize);
+
+    // The metadata is stored in binary chunks of the model file. This additionally writes it to a JSON file next to the
+    // model file which is easier to inspect while debugging. Disabled by default.
+    void setWriteJsonMetadata(bool write);
+
+    // Compresses the chunks of the model file which makes it smaller and faster to read from disk. Compressed files
+    // need version 3 of the format so older versions of the engine can't read them. Disabled by default.
+    void setCompressChunks(bool compress);
+
+    // Skips the conversion if the existing output was converted from the same source file with the same settings. The
+    // source hash is stored in the model file. Enabled by default.
+    void setUseConversionCache(bool use);
+
     void convertModel(const std::string& input_file,
                       const std::string& output_name, const std::string& output_directory);
 };
@@ -0,0 +1,355 @@
+//
+//
+
+#include "MeshOptimizer.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <deque>
+
+namespace {
+// Size of a memory transaction and the number of transactions kept in the simulated vertex fetch cache
+const size_t FETCH_LINE_SIZE = 64;
+const size_t FETCH_CACHE_LINES = 64;
+
+// Splitting clusters into very small pieces does not reduce overdraw since the triangles are drawn in order anyway
+const size_t MIN_CLUSTER_TRIANGLES = 32;
+
+// Counts the vertices which miss a FIFO cache of the given size
+class CacheSimulator {
+    std::vector<size_t> _timestamps;
+    size_t _cacheSize;
+    size_t _time;
+ public:
+    CacheSimulator(size_t vertexCount, size_t cacheSize)
+        : _timestamps(vertexCount, 0), _cacheSize(cacheSize), _time(cacheSize + 1) {
+    }
+
+    // Returns true if the vertex had to be transformed
+    bool access(uint32_t vertex) {
+        if (_time - _timestamps[vertex] > _cacheSize) {
+            _timestamps[vertex] = _time++;
+            return true;
+        }
+        return false;
+    }
+
+    void reset() {
+        // Moving the time forward evicts all vertices
+        _time += _cacheSize + 1;
+    }
+};
+
+struct Adjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+};
+
+Adjacency buildAdjacency(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    Adjacency adjacency;
+    adjacency.offsets.resize(vertexCount + 1, 0);
+
+    for (auto index : indices) {
+        ++adjacency.offsets[index + 1];
+    }
+    for (size_t i = 0; i < vertexCount; ++i) {
+        adjacency.offsets[i + 1] += adjacency.offsets[i];
+    }
+
+    std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    adjacency.triangles.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    return adjacency;
+}
+
+const int64_t NO_VERTEX = -1;
+
+int64_t skipDeadEnd(const std::vector<uint32_t>& liveTriangles,
+                    std::vector<uint32_t>& deadEndStack,
+                    size_t& cursor) {
+    // Recently used vertices are still likely to be in the cache
+    while (!deadEndStack.empty()) {
+        auto vertex = deadEndStack.back();
+        deadEndStack.pop_back();
+
+        if (liveTriangles[vertex] > 0) {
+            return vertex;
+        }
+    }
+
+    while (cursor < liveTriangles.size()) {
+        if (liveTriangles[cursor] > 0) {
+            return static_cast<int64_t>(cursor);
+        }
+        ++cursor;
+    }
+
+    return NO_VERTEX;
+}
+}
+
+namespace mesh_optimizer {
+
+MeshStatistics analyzeMesh(const std::vector<uint32_t>& indices,
+                           size_t vertexCount,
+                           size_t vertexSize,
+                           size_t cacheSize) {
+    MeshStatistics stats;
+    if (indices.empty() || vertexCount == 0) {
+        return stats;
+    }
+
+    CacheSimulator cache(vertexCount, cacheSize);
+    std::deque<size_t> fetchCache;
+
+    size_t transformed = 0;
+    size_t fetchedLines = 0;
+    for (auto index : indices) {
+        if (!cache.access(index)) {
+            continue;
+        }
+        ++transformed;
+
+        // A vertex may span multiple lines
+        auto firstLine = index * vertexSize / FETCH_LINE_SIZE;
+        auto lastLine = ((index + 1) * vertexSize - 1) / FETCH_LINE_SIZE;
+        for (auto line = firstLine; line <= lastLine; ++line) {
+            if (std::find(fetchCache.begin(), fetchCache.end(), line) != fetchCache.end()) {
+                continue;
+            }
+
+            ++fetchedLines;
+            fetchCache.push_back(line);
+            if (fetchCache.size() > FETCH_CACHE_LINES) {
+                fetchCache.pop_front();
+            }
+        }
+    }
+
+    stats.acmr = (float) transformed / (indices.size() / 3);
+    stats.atvr = (float) transformed / vertexCount;
+    stats.overfetch = (float) (fetchedLines * FETCH_LINE_SIZE) / (vertexCount * vertexSize);
+
+    return stats;
+}
+
+std::vector<size_t> optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize) {
+    Assertion(indices.size() % 3 == 0, "Indices are not a triangle list!");
+
+    std::vector<size_t> clusters;
+    if (indices.empty()) {
+        return clusters;
+    }
+
+    auto adjacency = buildAdjacency(indices, vertexCount);
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        liveTriangles[i] = adjacency.offsets[i + 1] - adjacency.offsets[i];
+    }
+
+    std::vector<size_t> timestamps(vertexCount, 0);
+    std::vector<bool> emitted(indices.size() / 3, false);
+    std::vector<uint32_t> deadEndStack;
+    std::vector<uint32_t> candidates;
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    size_t time = cacheSize + 1;
+    size_t cursor = 0;
+
+    clusters.push_back(0);
+    int64_t fanningVertex = 0;
+    while (fanningVertex != NO_VERTEX) {
+        candidates.clear();
+
+        auto begin = adjacency.offsets[fanningVertex];
+        auto end = adjacency.offsets[fanningVertex + 1];
+        for (auto i = begin; i < end; ++i) {
+            auto triangle = adjacency.triangles[i];
+            if (emitted[triangle]) {
+                continue;
+            }
+
+            for (size_t corner = 0; corner < 3; ++corner) {
+                auto vertex = indices[triangle * 3 + corner];
+
+                output.push_back(vertex);
+                deadEndStack.push_back(vertex);
+                candidates.push_back(vertex);
+                --liveTriangles[vertex];
+
+                if (time - timestamps[vertex] > cacheSize) {
+                    timestamps[vertex] = time++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // Prefer the candidate which will still be in the cache after all its remaining triangles were emitted
+        int64_t nextVertex = NO_VERTEX;
+        int64_t bestPriority = -1;
+        for (auto vertex : candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+
+            int64_t priority = 0;
+            if (time - timestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = static_cast<int64_t>(time - timestamps[vertex]);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                nextVertex = vertex;
+            }
+        }
+
+        if (nextVertex == NO_VERTEX) {
+            nextVertex = skipDeadEnd(liveTriangles, deadEndStack, cursor);
+
+            if (nextVertex != NO_VERTEX && output.size() / 3 > clusters.back()) {
+                clusters.push_back(output.size() / 3);
+            }
+        }
+
+        fanningVertex = nextVertex;
+    }
+
+    Assertion(output.size() == indices.size(), "Not all triangles were emitted!");
+    indices = std::move(output);
+
+    return clusters;
+}
+
+void optimizeOverdraw(std::vector<uint32_t>& indices,
+                      const std::vector<glm::vec3>& positions,
+                      const std::vector<size_t>& clusters,
+                      float threshold,
+                      size_t cacheSize) {
+    auto numTriangles = indices.size() / 3;
+    if (numTriangles == 0) {
+        return;
+    }
+
+    auto baseStats = analyzeMesh(indices, positions.size(), 1, cacheSize);
+
+    // Split the clusters at positions where the cache efficiency up to that point is good enough
+    std::vector<size_t> splitClusters;
+    {
+        CacheSimulator cache(positions.size(), cacheSize);
+        size_t nextHardBoundary = 0;
+        size_t clusterStart = 0;
+        size_t clusterMisses = 0;
+
+        for (size_t triangle = 0; triangle < numTriangles; ++triangle) {
+            if (nextHardBoundary < clusters.size() && clusters[nextHardBoundary] == triangle) {
+                ++nextHardBoundary;
+                splitClusters.push_back(triangle);
+                clusterStart = triangle;
+                clusterMisses = 0;
+                cache.reset();
+            }
+
+            for (size_t corner = 0; corner < 3; ++corner) {
+                if (cache.access(indices[triangle * 3 + corner])) {
+                    ++clusterMisses;
+                }
+            }
+
+            auto clusterTriangles = triangle + 1 - clusterStart;
+            auto clusterAcmr = (float) clusterMisses / clusterTriangles;
+            if (clusterTriangles >= MIN_CLUSTER_TRIANGLES && clusterAcmr <= baseStats.acmr * threshold
+                && triangle + 1 < numTriangles) {
+                splitClusters.push_back(triangle + 1);
+                clusterStart = triangle + 1;
+                clusterMisses = 0;
+                cache.reset();
+            }
+        }
+    }
+
+    if (splitClusters.empty() || splitClusters.front() != 0) {
+        splitClusters.insert(splitClusters.begin(), 0);
+    }
+
+    glm::vec3 meshCentroid(0.f);
+    for (auto index : indices) {
+        meshCentroid += positions[index];
+    }
+    meshCentroid /= (float) indices.size();
+
+    // Clusters which face away from the center of the mesh are likely to occlude the rest of it
+    struct ClusterSortData {
+        size_t begin;
+        size_t end;
+        float sort_key;
+    };
+    std::vector<ClusterSortData> sortData;
+    for (size_t i = 0; i < splitClusters.size(); ++i) {
+        ClusterSortData data;
+        data.begin = splitClusters[i];
+        data.end = i + 1 < splitClusters.size() ? splitClusters[i + 1] : numTriangles;
+
+        glm::vec3 centroid(0.f);
+        glm::vec3 normal(0.f);
+        float area = 0.f;
+        for (auto triangle = data.begin; triangle < data.end; ++triangle) {
+            auto& p0 = positions[indices[triangle * 3 + 0]];
+            auto& p1 = positions[indices[triangle * 3 + 1]];
+            auto& p2 = positions[indices[triangle * 3 + 2]];
+
+            // The length of the cross product is twice the area so the normal is already area weighted
+            auto triangleNormal = glm::cross(p1 - p0, p2 - p0);
+            auto triangleArea = glm::length(triangleNormal);
+
+            centroid += (p0 + p1 + p2) / 3.f * triangleArea;
+            normal += triangleNormal;
+            area += triangleArea;
+        }
+
+        if (area > 0.f) {
+            centroid /= area;
+        }
+        auto normalLength = glm::length(normal);
+        if (normalLength > 0.f) {
+            normal /= normalLength;
+        }
+
+        data.sort_key = glm::dot(centroid - meshCentroid, normal);
+        sortData.push_back(data);
+    }
+
+    std::stable_sort(sortData.begin(), sortData.end(), [](const ClusterSortData& lhs, const ClusterSortData& rhs) {
+        return lhs.sort_key > rhs.sort_key;
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (auto& cluster : sortData) {
+        output.insert(output.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    }
+    indices = std::move(output);
+}
+
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, size_t& usedVertices) {
+    std::vector<uint32_t> remap(vertexCount, UNUSED_VERTEX);
+
+    uint32_t nextVertex = 0;
+    for (auto& index : indices) {
+        if (remap[index] == UNUSED_VERTEX) {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+
+    usedVertices = nextVertex;
+    return remap;
+}
+}
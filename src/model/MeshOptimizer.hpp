@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mesh_optimizer {
+
+// Size of the simulated FIFO post-transform cache. Actual hardware caches differ but the ordering works well with a
+// wide range of sizes.
+const size_t DEFAULT_CACHE_SIZE = 16;
+
+struct MeshStatistics {
+    // Average cache miss ratio: transformed vertices per triangle. 0.5 is optimal for large regular meshes, 3 is the
+    // worst possible value.
+    float acmr;
+    // Average transform to vertex ratio: transformed vertices per vertex. 1 is optimal.
+    float atvr;
+    // Bytes read from vertex memory divided by the size of the vertex data. 1 is optimal.
+    float overfetch;
+
+    MeshStatistics() : acmr(0.f), atvr(0.f), overfetch(0.f) {
+    }
+};
+
+// Simulates a FIFO post-transform cache and a vertex fetch cache to measure how well the mesh can be processed by the
+// GPU. The indices are triangle lists.
+MeshStatistics analyzeMesh(const std::vector<uint32_t>& indices,
+                           size_t vertexCount,
+                           size_t vertexSize,
+                           size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+// Reorders the triangles to improve the post-transform cache hit rate using the Tipsify algorithm by Sander, Nehab and
+// Barczak. Returns the index of the first triangle of each cluster. Clusters start where the algorithm had to jump to a
+// disconnected part of the mesh, the triangles of different clusters can be reordered without hurting the cache much.
+std::vector<size_t> optimizeVertexCache(std::vector<uint32_t>& indices,
+                                        size_t vertexCount,
+                                        size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+// Reorders the clusters so that triangles which are likely to occlude other parts of the mesh are drawn first. The
+// clusters are split further as long as the cache miss ratio does not get worse than the threshold times the ratio of
+// the input. The positions are indexed by the vertex indices.
+void optimizeOverdraw(std::vector<uint32_t>& indices,
+                      const std::vector<glm::vec3>& positions,
+                      const std::vector<size_t>& clusters,
+                      float threshold = 1.05f,
+                      size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+// Computes a vertex order in which the vertices are used by the indices and updates the indices to it. Returns the new
+// position of every vertex or UNUSED_VERTEX if it is not referenced. The number of referenced vertices is written to
+// usedVertices.
+const uint32_t UNUSED_VERTEX = UINT32_MAX;
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, size_t& usedVertices);
+
+// Moves the vertices to the positions returned by optimizeVertexFetch and removes unused vertices
+template<typename TVertex>
+std::vector<TVertex> remapVertices(const std::vector<TVertex>& vertices,
+                                   const std::vector<uint32_t>& remap,
+                                   size_t usedVertices) {
+    std::vector<TVertex> remapped(usedVertices);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (remap[i] != UNUSED_VERTEX) {
+            remapped[remap[i]] = vertices[i];
+        }
+    }
+    return remapped;
+}
+}
@@ -3,61 +3,146 @@
 
 #include "Model.hpp"
 
+#include <glm/gtc/packing.hpp>
+
+namespace {
+// Degenerate triangles may have zero length normals or tangents which would produce NaNs when normalized
+glm::vec3 safeNormalize(const glm::vec3& vec) {
+    auto length = glm::length(vec);
+    return length > 0.f ? vec / length : vec;
+}
+}
+
 Model::Model(Renderer* renderer)
-    : _renderer(renderer), _alignedUniformData(renderer->getLimits().uniform_offset_alignment), _numDrawCalls(0) {
-
-    _vertexInputState.addComponent(AttributeType::Position,
-                                   0,
-                                   DataFormat::Vec3,
-                                   offsetof(ModelVertexData, position));
-    _vertexInputState.addComponent(AttributeType::TexCoord,
-                                   0,
-                                   DataFormat::Vec3,
-                                   offsetof(ModelVertexData, tex_coord));
-    _vertexInputState.addComponent(AttributeType::Normal,
-                                   0,
-                                   DataFormat::Vec3,
-                                   offsetof(ModelVertexData, normal));
-    _vertexInputState.addComponent(AttributeType::Tangent,
-                                   0,
-                                   DataFormat::Vec3,
-                                   offsetof(ModelVertexData, tangent));
-    _vertexInputState.addComponent(AttributeType::Bitangent,
-                                   0,
-                                   DataFormat::Vec3,
-                                   offsetof(ModelVertexData, bitangent));
-
-    _vertexInputState.addBufferBinding(0, false, sizeof(ModelVertexData));
+    : _geometryHeap(nullptr), _vertexArrayObject(nullptr), _renderer(renderer),
+      _alignedUniformData(renderer, renderer->getLimits().uniform_offset_alignment), _numDrawCalls(0) {
+}
+
+PackedModelVertexData packModelVertex(const ModelVertexData& vertex) {
+    PackedModelVertexData packed;
+    packed.position = vertex.position;
+    packed.tex_coord[0] = glm::packHalf1x16(vertex.tex_coord.x);
+    packed.tex_coord[1] = glm::packHalf1x16(vertex.tex_coord.y);
+    packed.normal = glm::packSnorm3x10_1x2(glm::vec4(safeNormalize(vertex.normal), 0.f));
+
+    // Mirrored texture coordinates flip the bitangent
+    auto handedness = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.f ? -1.f : 1.f;
+    packed.tangent = glm::packSnorm3x10_1x2(glm::vec4(safeNormalize(vertex.tangent), handedness));
+
+    return packed;
+}
+
+ModelVertexData unpackModelVertex(const PackedModelVertexData& vertex) {
+    ModelVertexData unpacked;
+    unpacked.position = vertex.position;
+    unpacked.tex_coord = glm::vec3(glm::unpackHalf1x16(vertex.tex_coord[0]),
+                                   glm::unpackHalf1x16(vertex.tex_coord[1]),
+                                   0.f);
+    unpacked.normal = glm::vec3(glm::unpackSnorm3x10_1x2(vertex.normal));
+
+    auto tangent = glm::unpackSnorm3x10_1x2(vertex.tangent);
+    unpacked.tangent = glm::vec3(tangent);
+    unpacked.bitangent = glm::cross(unpacked.normal, unpacked.tangent) * tangent.w;
+
+    return unpacked;
+}
+
+size_t getModelVertexSize(ModelVertexFormat format) {
+    switch (format) {
+        case ModelVertexFormat::Float:
+            return sizeof(ModelVertexData);
+        case ModelVertexFormat::Packed:
+            return sizeof(PackedModelVertexData);
+    }
+    return sizeof(ModelVertexData);
+}
+
+VertexInputStateProperties Model::createVertexInputState(ModelVertexFormat format) {
+    VertexInputStateProperties vertexInputState;
+
+    if (format == ModelVertexFormat::Packed) {
+        vertexInputState.addComponent(AttributeType::Position,
+                                      0,
+                                      DataFormat::Vec3,
+                                      offsetof(PackedModelVertexData, position));
+        vertexInputState.addComponent(AttributeType::TexCoord,
+                                      0,
+                                      DataFormat::HalfVec2,
+                                      offsetof(PackedModelVertexData, tex_coord));
+        vertexInputState.addComponent(AttributeType::Normal,
+                                      0,
+                                      DataFormat::SNorm10Vec3W2,
+                                      offsetof(PackedModelVertexData, normal));
+        vertexInputState.addComponent(AttributeType::Tangent,
+                                      0,
+                                      DataFormat::SNorm10Vec3W2,
+                                      offsetof(PackedModelVertexData, tangent));
+
+        vertexInputState.addBufferBinding(0, false, sizeof(PackedModelVertexData));
+
+        return vertexInputState;
+    }
+
+    vertexInputState.addComponent(AttributeType::Position,
+                                  0,
+                                  DataFormat::Vec3,
+                                  offsetof(ModelVertexData, position));
+    vertexInputState.addComponent(AttributeType::TexCoord,
+                                  0,
+                                  DataFormat::Vec3,
+                                  offsetof(ModelVertexData, tex_coord));
+    vertexInputState.addComponent(AttributeType::Normal,
+                                  0,
+                                  DataFormat::Vec3,
+                                  offsetof(ModelVertexData, normal));
+    vertexInputState.addComponent(AttributeType::Tangent,
+                                  0,
+                                  DataFormat::Vec3,
+                                  offsetof(ModelVertexData, tangent));
+    vertexInputState.addComponent(AttributeType::Bitangent,
+                                  0,
+                                  DataFormat::Vec3,
+                                  offsetof(ModelVertexData, bitangent));
+
+    vertexInputState.addBufferBinding(0, false, sizeof(ModelVertexData));
+
+    return vertexInputState;
 }
 
 Model::~Model() {
+    auto uploads = _renderer->getUploadQueue();
+    for (auto& material : _materials) {
+        if (material.diffuse_upload != 0) {
+            uploads->cancel(material.diffuse_upload);
+        }
+    }
 
+    destroyDescriptorSets(_rootNode);
+
+    if (_geometry.isValid()) {
+        _geometryHeap->free(_geometry);
+    }
 }
 void Model::setRootNode(ModelNode&& node) {
+    destroyDescriptorSets(_rootNode);
     _rootNode = std::move(node);
 
     _numDrawCalls = updateNodeIndices(_rootNode, 0);
 
-    _alignedUniformData.resize(_numDrawCalls);
-
-    _nodeUniformData = _renderer->createBuffer(BufferType::Uniform);
-    _nodeUniformData->setData(nullptr, _alignedUniformData.getSize(), BufferUsage::Streaming);
+    _nodePositions.resize(_numDrawCalls);
 
     initializeDescriptorSets(_rootNode);
 }
 
-void Model::setModelData(std::unique_ptr<BufferObject>&& data_buffer, std::unique_ptr<BufferObject>&& index_buffer) {
-    _modelData = std::move(data_buffer);
-    _indexData = std::move(index_buffer);
-
-    VertexArrayProperties vaoProps;
-    vaoProps.addBufferBinding(0, _modelData.get());
+void Model::setModelData(GeometryHeap* heap, const GeometryAllocation& geometry) {
+    if (_geometry.isValid()) {
+        _geometryHeap->free(_geometry);
+    }
 
-    vaoProps.indexBuffer = _indexData.get();
-    vaoProps.indexOffset = 0;
-    vaoProps.indexType = IndexType::Short;
+    _geometryHeap = heap;
+    _geometry = geometry;
 
-    _vertexArrayObject = _renderer->createVertexArrayObject(_vertexInputState, vaoProps);
+    _vertexArrayObject = _geometryHeap->getVertexArrayObject(_geometry);
 }
 
 void Model::setMeshData(std::vector<MeshData>&& data) {
@@ -68,7 +153,7 @@ void Model::setMaterials(std::vector<Material>&& data) {
     _materials = std::move(data);
 }
 void Model::render(CommandBuffer* cmd) {
-    cmd->bindVertexArrayObject(_vertexArrayObject.get());
+    cmd->bindVertexArrayObject(_vertexArrayObject);
 
     recursiveRender(cmd, _rootNode);
 }
@@ -76,9 +161,15 @@ void Model::recursiveRender(CommandBuffer* cmd, const ModelNode& node) {
     for (auto& node_data : node.mesh_data) {
         auto& mesh = _meshData[node_data.mesh_index];
 
-        cmd->bindDescriptorSet(node_data.model_descriptor_set.get());
-        cmd->drawIndexed(mesh.vertex_count, 1, mesh.vertex_offset, mesh.base_vertex, 0);
-        cmd->unbindDescriptorSet(node_data.model_descriptor_set);
+        auto descriptorSet = _renderer->getDescriptorSet(node_data.model_descriptor_set);
+
+        cmd->bindDescriptorSet(descriptorSet);
+        cmd->drawIndexed(mesh.vertex_count,
+                         1,
+                         _geometry.first_index + mesh.vertex_offset,
+                         _geometry.base_vertex + mesh.base_vertex,
+                         0);
+        cmd->unbindDescriptorSet(descriptorSet);
     }
 
     for (auto& child : node.child_nodes) {
@@ -86,13 +177,54 @@ void Model::recursiveRender(CommandBuffer* cmd, const ModelNode& node) {
     }
 }
 
+void Model::enqueue(RenderQueue& queue, uint32_t pass, PipelineState* pipeline, const glm::mat4& view) {
+    recursiveEnqueue(queue, pass, pipeline, view, _rootNode);
+}
+void Model::recursiveEnqueue(RenderQueue& queue,
+                             uint32_t pass,
+                             PipelineState* pipeline,
+                             const glm::mat4& view,
+                             const ModelNode& node) {
+    size_t i = 0;
+    for (auto& node_data : node.mesh_data) {
+        auto& mesh = _meshData[node_data.mesh_index];
+
+        auto nodePosition = view * _nodePositions[node.index + i];
+        // The camera looks along the negative z-axis in view space
+        auto depth = -nodePosition.z;
+
+        RenderQueueItem item;
+        item.pipeline = pipeline;
+        item.descriptor_set = _renderer->getDescriptorSet(node_data.model_descriptor_set);
+        item.vertex_array = _vertexArrayObject;
+        item.indexed = true;
+        item.count = mesh.vertex_count;
+        item.offset = _geometry.first_index + mesh.vertex_offset;
+        item.base_vertex = _geometry.base_vertex + mesh.base_vertex;
+
+        queue.add(pass, item, depth);
+        ++i;
+    }
+
+    for (auto& child : node.child_nodes) {
+        recursiveEnqueue(queue, pass, pipeline, view, *child);
+    }
+}
+
 void Model::prepareData(const glm::mat4& world_transform) {
+    if (_numDrawCalls == 0) {
+        return;
+    }
+
+    _alignedUniformData.reset();
+    _alignedUniformData.resize(_numDrawCalls);
+
     updateUniformData(_rootNode, world_transform);
 
-    _nodeUniformData->updateData(_alignedUniformData.getData(),
-                                 0,
-                                 _alignedUniformData.getSize(),
-                                 UpdateFlags::DiscardOldData);
+    _alignedUniformData.finish();
+
+    // The uniforms are placed in a different location every frame so the descriptor sets need to be updated as well
+    updateDescriptorSets(_rootNode);
 }
 size_t Model::updateNodeIndices(ModelNode& node, size_t nextIndex) {
     node.index = nextIndex;
@@ -105,33 +237,62 @@ size_t Model::updateNodeIndices(ModelNode& node, size_t nextIndex) {
     return nextIndex;
 }
 void Model::initializeDescriptorSets(ModelNode& node) {
-    size_t i = 0;
     for (auto& node_data : node.mesh_data) {
         auto& mesh = _meshData[node_data.mesh_index];
         auto& material = _materials[mesh.material_index];
 
-        auto descriptor_set = _renderer->createDescriptorSet(DescriptorSetType::ModelSet);
+        node_data.model_descriptor_set = _renderer->createDescriptorSetHandle(DescriptorSetType::ModelSet);
+
+        auto descriptor_set = _renderer->getDescriptorSet(node_data.model_descriptor_set);
         descriptor_set->getDescriptor(DescriptorSetPart::ModelSet_DiffuseTexture)->setTexture(material.diffuse_texture.get());
-        descriptor_set->getDescriptor(DescriptorSetPart::ModelSet_Uniforms)->setUniformBuffer(_nodeUniformData.get(),
-                                                                                              _alignedUniformData.getOffset(
-                                                                                                  node.index + i),
-                                                                                              sizeof(ModelUniformData));
+    }
 
-        node_data.model_descriptor_set = std::move(descriptor_set);
+    for (auto& child : node.child_nodes) {
+        initializeDescriptorSets(*child);
+    }
+}
+void Model::updateDescriptorSets(const ModelNode& node) {
+    size_t i = 0;
+    for (auto& node_data : node.mesh_data) {
+        auto descriptor_set = _renderer->getDescriptorSet(node_data.model_descriptor_set);
+        auto range = _alignedUniformData.getElementRange(node.index + i);
+
+        descriptor_set->getDescriptor(DescriptorSetPart::ModelSet_Uniforms)->setUniformBuffer(range.buffer,
+                                                                                              range.offset,
+                                                                                              range.size);
 
         ++i;
     }
 
     for (auto& child : node.child_nodes) {
-        initializeDescriptorSets(*child);
+        updateDescriptorSets(*child);
+    }
+}
+void Model::destroyDescriptorSets(ModelNode& node) {
+    for (auto& node_data : node.mesh_data) {
+        if (node_data.model_descriptor_set) {
+            _renderer->destroyDescriptorSet(node_data.model_descriptor_set);
+            node_data.model_descriptor_set = DescriptorSetHandle();
+        }
+    }
+
+    for (auto& child : node.child_nodes) {
+        destroyDescriptorSets(*child);
     }
 }
 void Model::updateUniformData(const ModelNode& node, const glm::mat4& model) {
     auto final_transform = model * node.transform;
 
-    auto data = _alignedUniformData.getElement(node.index);
-    data->model_matrix = final_transform;
-    data->normal_model_matrix = glm::transpose(glm::inverse(final_transform));
+    auto normal_transform = glm::transpose(glm::inverse(final_transform));
+
+    // Every mesh of the node has its own element since each draw binds its own range
+    for (size_t i = 0; i < node.mesh_data.size(); ++i) {
+        auto data = _alignedUniformData.getElement(node.index + i);
+        data->model_matrix = final_transform;
+        data->normal_model_matrix = normal_transform;
+
+        _nodePositions[node.index + i] = final_transform[3];
+    }
 
     for (auto& child : node.child_nodes) {
         updateUniformData(*child, final_transform);
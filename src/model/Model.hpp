@@ -3,6 +3,8 @@
 #include <renderer/BufferObject.hpp>
 #include <renderer/VertexLayout.hpp>
 #include <renderer/Renderer.hpp>
+#include <renderer/RenderQueue.hpp>
+#include <renderer/GeometryHeap.hpp>
 
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
@@ -10,7 +12,13 @@
 
 #include <memory>
 #include <vector>
-#include <util/UniformAligner.hpp>
+#include <util/StreamingUniformAligner.hpp>
+
+// The layout of the vertex data of a model file, see doc/model_format.md
+enum class ModelVertexFormat : uint32_t {
+    Float = 0,
+    Packed = 1
+};
 
 struct ModelVertexData {
     glm::vec3 position;
@@ -20,9 +28,30 @@ struct ModelVertexData {
     glm::vec3 bitangent;
 };
 
+// Compact version of ModelVertexData. The texture coordinates are half floats and the normal and tangent are signed
+// normalized 10_10_10_2 values. The bitangent is not stored, the w component of the tangent contains the sign which
+// is needed for computing it as cross(normal, tangent.xyz) * tangent.w.
+struct PackedModelVertexData {
+    glm::vec3 position;
+    uint16_t tex_coord[2];
+    uint32_t normal;
+    uint32_t tangent;
+};
+static_assert(sizeof(PackedModelVertexData) == 24, "Packed vertex data is not tightly packed!");
+
+PackedModelVertexData packModelVertex(const ModelVertexData& vertex);
+
+ModelVertexData unpackModelVertex(const PackedModelVertexData& vertex);
+
+size_t getModelVertexSize(ModelVertexFormat format);
+
 struct Material {
     std::string name;
     std::unique_ptr<Texture> diffuse_texture;
+    // The upload of the texture data is cancelled if the model is destroyed before it is complete
+    UploadTicket diffuse_upload;
+
+    Material() : diffuse_upload(0) { }
 };
 
 struct MeshData {
@@ -40,7 +69,8 @@ struct MeshData {
 
 struct NodeMeshData {
     size_t mesh_index;
-    std::unique_ptr<DescriptorSet> model_descriptor_set;
+    // Allocated from the descriptor set pool of the renderer since a model may have a lot of meshes
+    DescriptorSetHandle model_descriptor_set;
 };
 
 struct ModelNode {
@@ -56,15 +86,18 @@ struct ModelNode {
 };
 
 class Model {
-    std::unique_ptr<BufferObject> _modelData;
-    std::unique_ptr<BufferObject> _indexData;
-    std::unique_ptr<BufferObject> _nodeUniformData;
+    // The vertex and index data is stored in a shared heap. The offsets of the allocation are added to the mesh offsets
+    // when the meshes are drawn.
+    GeometryHeap* _geometryHeap;
+    GeometryAllocation _geometry;
 
-    std::unique_ptr<VertexArrayObject> _vertexArrayObject;
+    VertexArrayObject* _vertexArrayObject;
 
     Renderer* _renderer;
 
-    UniformAligner<ModelUniformData> _alignedUniformData;
+    // Written directly into streaming memory so it can't be read back. The positions are kept separately for sorting.
+    StreamingUniformAligner<ModelUniformData> _alignedUniformData;
+    std::vector<glm::vec4> _nodePositions;
 
     std::vector<MeshData> _meshData;
     std::vector<Material> _materials;
@@ -73,15 +106,23 @@ class Model {
 
     size_t _numDrawCalls;
 
-    VertexInputStateProperties _vertexInputState;
-
     size_t updateNodeIndices(ModelNode& node, size_t nextIndex);
 
     void initializeDescriptorSets(ModelNode& node);
 
+    void destroyDescriptorSets(ModelNode& node);
+
+    void updateDescriptorSets(const ModelNode& node);
+
     void updateUniformData(const ModelNode& node, const glm::mat4& model);
 
     void recursiveRender(CommandBuffer* cmd, const ModelNode& node);
+
+    void recursiveEnqueue(RenderQueue& queue,
+                          uint32_t pass,
+                          PipelineState* pipeline,
+                          const glm::mat4& view,
+                          const ModelNode& node);
  public:
     explicit Model(Renderer* renderer);
     ~Model();
@@ -92,12 +133,16 @@ class Model {
 
     void setMaterials(std::vector<Material>&& data);
 
-    void setModelData(std::unique_ptr<BufferObject>&& data_buffer, std::unique_ptr<BufferObject>&& index_buffer);
+    void setModelData(GeometryHeap* heap, const GeometryAllocation& geometry);
 
     void prepareData(const glm::mat4& world_transform);
 
     void render(CommandBuffer* cmd);
 
+    // Adds the draws of this model to the queue. The depth of each draw is computed with the specified view matrix
+    // so prepareData has to be called before this.
+    void enqueue(RenderQueue& queue, uint32_t pass, PipelineState* pipeline, const glm::mat4& view);
+
     const std::vector<MeshData>& getMeshData() const {
         return _meshData;
     }
@@ -105,7 +150,6 @@ class Model {
         return _materials;
     }
 
-    const VertexInputStateProperties& getVertexInputState() const {
-        return _vertexInputState;
-    }
+    // The vertex input state of models with the specified vertex format. Geometry heaps for models have to use this.
+    static VertexInputStateProperties createVertexInputState(ModelVertexFormat format);
 };
@@ -0,0 +1,273 @@
+//
+//
+
+#include "ModelCompression.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+
+const size_t HASH_BITS = 16;
+const uint32_t NO_POSITION = UINT32_MAX;
+
+// Lengths which do not fit into the four bits of the token are continued in additional bytes
+const size_t TOKEN_LENGTH_LIMIT = 15;
+
+uint32_t read32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+    // Multiplicative hashing, the upper bits are the best mixed ones
+    return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+void writeLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+bool readLength(const uint8_t*& data, const uint8_t* end, size_t& length) {
+    uint8_t value;
+    do {
+        if (data == end) {
+            return false;
+        }
+        value = *data++;
+        length += value;
+    } while (value == 255);
+
+    return true;
+}
+
+// A sequence is a number of literal bytes followed by a match. The last sequence only has literals.
+void writeSequence(std::vector<uint8_t>& out,
+                   const uint8_t* literals,
+                   size_t literalLength,
+                   size_t offset,
+                   size_t matchLength) {
+    auto literalToken = std::min(literalLength, TOKEN_LENGTH_LIMIT);
+    auto matchToken = matchLength == 0 ? 0 : std::min(matchLength - MIN_MATCH, TOKEN_LENGTH_LIMIT);
+    out.push_back(static_cast<uint8_t>(literalToken << 4 | matchToken));
+
+    if (literalToken == TOKEN_LENGTH_LIMIT) {
+        writeLength(out, literalLength - TOKEN_LENGTH_LIMIT);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+
+    if (matchLength == 0) {
+        return;
+    }
+
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchToken == TOKEN_LENGTH_LIMIT) {
+        writeLength(out, matchLength - MIN_MATCH - TOKEN_LENGTH_LIMIT);
+    }
+}
+
+uint32_t zigzagEncode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t zigzagDecode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+uint32_t readIndex(const uint8_t* data, size_t indexSize) {
+    if (indexSize == sizeof(uint16_t)) {
+        uint16_t index;
+        std::memcpy(&index, data, sizeof(index));
+        return index;
+    }
+
+    uint32_t index;
+    std::memcpy(&index, data, sizeof(index));
+    return index;
+}
+
+void writeIndex(uint8_t* data, size_t indexSize, uint32_t index) {
+    if (indexSize == sizeof(uint16_t)) {
+        auto shortIndex = static_cast<uint16_t>(index);
+        std::memcpy(data, &shortIndex, sizeof(shortIndex));
+    } else {
+        std::memcpy(data, &index, sizeof(index));
+    }
+}
+}
+
+namespace model_compression {
+
+std::vector<uint8_t> compressLZ(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> out;
+    out.reserve(size / 2 + 16);
+
+    std::vector<uint32_t> table(1 << HASH_BITS, NO_POSITION);
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + MIN_MATCH <= size) {
+        auto sequence = read32(data + pos);
+        auto hash = hashSequence(sequence);
+
+        auto candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos);
+
+        if (candidate == NO_POSITION || pos - candidate > MAX_OFFSET || read32(data + candidate) != sequence) {
+            ++pos;
+            continue;
+        }
+
+        auto length = MIN_MATCH;
+        while (pos + length < size && data[candidate + length] == data[pos + length]) {
+            ++length;
+        }
+
+        writeSequence(out, data + anchor, pos - anchor, pos - candidate, length);
+
+        pos += length;
+        anchor = pos;
+    }
+
+    writeSequence(out, data + anchor, size - anchor, 0, 0);
+
+    return out;
+}
+
+bool decompressLZ(const uint8_t* data, size_t size, uint8_t* out, size_t outSize) {
+    auto end = data + size;
+    size_t written = 0;
+
+    while (true) {
+        if (data == end) {
+            return false;
+        }
+        auto token = *data++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == TOKEN_LENGTH_LIMIT && !readLength(data, end, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<size_t>(end - data) || literalLength > outSize - written) {
+            return false;
+        }
+        if (literalLength > 0) {
+            std::memcpy(out + written, data, literalLength);
+        }
+        data += literalLength;
+        written += literalLength;
+
+        // Only the last sequence ends without a match
+        if (written == outSize) {
+            return data == end;
+        }
+
+        if (end - data < 2) {
+            return false;
+        }
+        size_t offset = data[0] | (data[1] << 8);
+        data += 2;
+
+        size_t matchLength = token & 0xF;
+        if (matchLength == TOKEN_LENGTH_LIMIT && !readLength(data, end, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+
+        if (offset == 0 || offset > written || matchLength > outSize - written) {
+            return false;
+        }
+
+        // Matches may overlap with the bytes they produce so they have to be copied byte by byte
+        auto source = out + written - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            out[written + i] = source[i];
+        }
+        written += matchLength;
+    }
+}
+
+std::vector<uint8_t> compressIndices(const uint8_t* data, size_t size, size_t indexSize) {
+    Assertion(indexSize == sizeof(uint16_t) || indexSize == sizeof(uint32_t), "Invalid index size!");
+
+    std::vector<uint8_t> encoded;
+    encoded.reserve(size / indexSize);
+
+    uint32_t previous = 0;
+    for (size_t offset = 0; offset + indexSize <= size; offset += indexSize) {
+        auto index = readIndex(data + offset, indexSize);
+        auto value = zigzagEncode(static_cast<int32_t>(index - previous));
+        previous = index;
+
+        while (value >= 0x80) {
+            encoded.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        encoded.push_back(static_cast<uint8_t>(value));
+    }
+
+    // The size of the encoded indices is needed for decompressing them
+    uint64_t encodedSize = encoded.size();
+    std::vector<uint8_t> out(sizeof(encodedSize));
+    std::memcpy(out.data(), &encodedSize, sizeof(encodedSize));
+
+    auto compressed = compressLZ(encoded.data(), encoded.size());
+    out.insert(out.end(), compressed.begin(), compressed.end());
+
+    return out;
+}
+
+bool decompressIndices(const uint8_t* data, size_t size, size_t indexSize, uint8_t* out, size_t outSize) {
+    Assertion(indexSize == sizeof(uint16_t) || indexSize == sizeof(uint32_t), "Invalid index size!");
+
+    uint64_t encodedSize;
+    if (size < sizeof(encodedSize) || outSize % indexSize != 0) {
+        return false;
+    }
+    std::memcpy(&encodedSize, data, sizeof(encodedSize));
+
+    // Every index needs at least one and at most five bytes
+    auto numIndices = outSize / indexSize;
+    if (encodedSize < numIndices || encodedSize > numIndices * 5) {
+        return false;
+    }
+
+    std::vector<uint8_t> encoded(static_cast<size_t>(encodedSize));
+    if (!decompressLZ(data + sizeof(encodedSize), size - sizeof(encodedSize), encoded.data(), encoded.size())) {
+        return false;
+    }
+
+    auto current = encoded.data();
+    auto end = encoded.data() + encoded.size();
+    uint32_t previous = 0;
+    for (size_t i = 0; i < numIndices; ++i) {
+        uint32_t value = 0;
+        for (uint32_t shift = 0;; shift += 7) {
+            if (current == end || shift > 28) {
+                return false;
+            }
+            auto byte = *current++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+
+        auto index = previous + static_cast<uint32_t>(zigzagDecode(value));
+        writeIndex(out + i * indexSize, indexSize, index);
+        previous = index;
+    }
+
+    return current == end;
+}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace model_compression {
+
+// Byte oriented LZ77 codec in the style of LZ4. It only compresses repeated byte sequences and has no entropy coding
+// stage but decompression is very fast. See doc/model_format.md for the format of the compressed data.
+std::vector<uint8_t> compressLZ(const uint8_t* data, size_t size);
+
+// Decompresses exactly outSize bytes into out. Returns false if the compressed data is malformed or does not match the
+// size.
+bool decompressLZ(const uint8_t* data, size_t size, uint8_t* out, size_t outSize);
+
+// Codec for triangle list indices. Every index is stored as the zigzag encoded difference to the previous index in a
+// variable length integer and the result is compressed with the LZ codec. Indices of optimized meshes mostly differ
+// by small amounts so most of them only need a single byte. indexSize is the size of one index, 2 or 4.
+std::vector<uint8_t> compressIndices(const uint8_t* data, size_t size, size_t indexSize);
+
+bool decompressIndices(const uint8_t* data, size_t size, size_t indexSize, uint8_t* out, size_t outSize);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// Definitions of the binary model format, see doc/model_format.md for the description of the chunks. The structs are
+// stored without padding but the chunks are not aligned inside the file so they have to be copied out before use.
+
+constexpr uint32_t makeChunkId(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    return ((uint32_t) ((d << 24) | (c << 16) | (b << 8) | a));
+}
+
+const uint32_t CHUNK_VERTEX_FORMAT = makeChunkId('V', 'F', 'M', 'T');
+const uint32_t CHUNK_VERTEX_DATA = makeChunkId('V', 'D', 'A', 'T');
+const uint32_t CHUNK_INDEX_DATA = makeChunkId('I', 'N', 'D', 'X');
+const uint32_t CHUNK_INDEX_DATA_32 = makeChunkId('I', 'D', 'X', '4');
+const uint32_t CHUNK_STRINGS = makeChunkId('S', 'T', 'R', 'S');
+const uint32_t CHUNK_MATERIALS = makeChunkId('M', 'A', 'T', 'L');
+const uint32_t CHUNK_MESHES = makeChunkId('M', 'E', 'S', 'H');
+const uint32_t CHUNK_NODES = makeChunkId('N', 'O', 'D', 'E');
+const uint32_t CHUNK_SOURCE_HASH = makeChunkId('S', 'R', 'C', 'H');
+
+// Files of this version and later have the compression method and the uncompressed size in every chunk header
+const uint32_t COMPRESSED_CHUNKS_VERSION = 3;
+
+enum class ChunkCompression : uint32_t {
+    None = 0,
+    LZ = 1,
+    Indices = 2 // Index codec of model_compression, only used for the index data chunks
+};
+
+// Strings are stored as byte offsets into the string table
+typedef uint32_t StringReference;
+
+struct FileMaterial {
+    StringReference name;
+    StringReference diffuse_texture;
+};
+static_assert(sizeof(FileMaterial) == 8, "File material is not tightly packed!");
+
+struct FileMesh {
+    uint64_t offset;
+    StringReference name;
+    uint32_t material_index;
+    uint32_t count;
+    uint32_t base_index;
+    uint32_t min_index;
+    uint32_t max_index;
+};
+static_assert(sizeof(FileMesh) == 32, "File mesh is not tightly packed!");
+
+const int32_t NO_PARENT_NODE = -1;
+
+struct FileNode {
+    glm::mat4 transform;
+    StringReference name;
+    int32_t parent; // Parents are always stored before their children
+    uint32_t first_mesh; // Index into the mesh references which follow the nodes
+    uint32_t mesh_count;
+};
+static_assert(sizeof(FileNode) == 80, "File node is not tightly packed!");
+
+// A chunk of a model file which still points into the file contents
+struct ModelChunk {
+    const uint8_t* data;
+    size_t size;
+
+    ModelChunk() : data(nullptr), size(0) {
+    }
+
+    bool isPresent() const {
+        return data != nullptr;
+    }
+};
@@ -2,17 +2,167 @@
 //
 
 #include "ModelLoader.hpp"
+#include "ModelCompression.hpp"
+#include "ModelFormat.hpp"
 
 #include <sstream>
+#include <util/Assertion.hpp>
 #include <util/textures.hpp>
-#include <fstream>
+#include <util/MemoryMappedFile.hpp>
+#include <algorithm>
 #include <cstring>
+#include <jansson.h>
+
+// Everything that is needed to create a model which can be produced without the renderer
+struct ModelLoadData {
+    struct Material {
+        std::string name;
+        std::string texture_path;
+        // Null if the texture could not be read
+        std::unique_ptr<gli::texture> diffuse_texture;
+    };
+
+    // The geometry points into the mapped file unless it had to be decompressed or converted
+    MemoryMappedFile file;
+    std::deque<std::vector<uint8_t>> decompressed_chunks;
+    std::vector<uint8_t> converted_vertices;
+
+    const uint8_t* vertex_data;
+    size_t vertex_size;
+    const uint8_t* index_data;
+    size_t index_size;
+    IndexType index_type;
+
+    std::vector<Material> materials;
+    std::vector<MeshData> meshes;
+    ModelNode root_node;
+
+    ModelLoadData()
+        : vertex_data(nullptr), vertex_size(0), index_data(nullptr), index_size(0), index_type(IndexType::Short) {
+    }
+};
 
 namespace {
-const int SUPPORTED_VERSION = 1;
+const std::chrono::microseconds DEFAULT_FINALIZE_BUDGET(2000);
+
+// Smallest page size of the supported platforms
+const size_t MIN_PAGE_SIZE = 4096;
+
+// Reads one byte of every page so the operating system loads the data from disk on the calling thread
+void touchPages(const uint8_t* data, size_t size) {
+    volatile uint8_t sink = 0;
+    for (size_t offset = 0; offset < size; offset += MIN_PAGE_SIZE) {
+        sink = sink + data[offset];
+    }
+}
 
-constexpr uint32_t FOURCC(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
-    return ((uint32_t) ((d << 24) | (c << 16) | (b << 8) | a));
+// Version 1 only supports float vertices, version 2 added packed vertices and version 3 compressed chunks
+const uint32_t MIN_SUPPORTED_VERSION = 1;
+const uint32_t MAX_SUPPORTED_VERSION = 3;
+
+// Identifier and version
+const size_t FILE_HEADER_SIZE = 8 + sizeof(uint32_t);
+// Type and length
+const size_t CHUNK_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+// Type, compression, stored length and uncompressed length
+const size_t COMPRESSED_CHUNK_HEADER_SIZE = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+// Neither codec can reach this ratio, larger sizes are caused by broken files
+const uint64_t MAX_COMPRESSION_RATIO = 1024;
+
+// Chunks which are not used by the loader are skipped without reading or decompressing their contents
+bool isLoadedChunk(uint32_t chunk_type) {
+    switch (chunk_type) {
+        case CHUNK_VERTEX_FORMAT:
+        case CHUNK_VERTEX_DATA:
+        case CHUNK_INDEX_DATA:
+        case CHUNK_INDEX_DATA_32:
+        case CHUNK_STRINGS:
+        case CHUNK_MATERIALS:
+        case CHUNK_MESHES:
+        case CHUNK_NODES:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool decompressChunk(uint32_t chunk_type,
+                     ChunkCompression compression,
+                     const uint8_t* data,
+                     size_t size,
+                     std::vector<uint8_t>& out) {
+    switch (compression) {
+        case ChunkCompression::LZ:
+            return model_compression::decompressLZ(data, size, out.data(), out.size());
+        case ChunkCompression::Indices:
+            if (chunk_type == CHUNK_INDEX_DATA) {
+                return model_compression::decompressIndices(data, size, sizeof(uint16_t), out.data(), out.size());
+            } else if (chunk_type == CHUNK_INDEX_DATA_32) {
+                return model_compression::decompressIndices(data, size, sizeof(uint32_t), out.data(), out.size());
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool readString(const ModelChunk& strings, StringReference reference, std::string& out) {
+    if (reference >= strings.size) {
+        fprintf(stderr, "String reference %u is outside of the string table!\n", reference);
+        return false;
+    }
+
+    auto begin = reinterpret_cast<const char*>(strings.data) + reference;
+    auto end = static_cast<const char*>(std::memchr(begin, '\0', strings.size - reference));
+    if (end == nullptr) {
+        fprintf(stderr, "String at %u is not terminated!\n", reference);
+        return false;
+    }
+
+    out.assign(begin, end);
+    return true;
+}
+
+// Reads the element count of an array chunk and checks that the chunk is large enough for the elements
+template<typename T>
+bool readArrayHeader(const ModelChunk& chunk, const char* name, uint32_t& count) {
+    if (chunk.size < sizeof(count)) {
+        fprintf(stderr, "%s chunk is too small!\n", name);
+        return false;
+    }
+    std::memcpy(&count, chunk.data, sizeof(count));
+
+    if ((chunk.size - sizeof(count)) / sizeof(T) < count) {
+        fprintf(stderr, "%s chunk is smaller than its number of elements!\n", name);
+        return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> convertVertexData(const uint8_t* data, size_t size, ModelVertexFormat from, ModelVertexFormat to) {
+    auto numVertices = size / getModelVertexSize(from);
+
+    std::vector<uint8_t> converted(numVertices * getModelVertexSize(to));
+    for (size_t i = 0; i < numVertices; ++i) {
+        ModelVertexData vertex;
+        if (from == ModelVertexFormat::Packed) {
+            PackedModelVertexData packed;
+            std::memcpy(&packed, data + i * sizeof(packed), sizeof(packed));
+            vertex = unpackModelVertex(packed);
+        } else {
+            std::memcpy(&vertex, data + i * sizeof(vertex), sizeof(vertex));
+        }
+
+        if (to == ModelVertexFormat::Packed) {
+            auto packed = packModelVertex(vertex);
+            std::memcpy(converted.data() + i * sizeof(packed), &packed, sizeof(packed));
+        } else {
+            std::memcpy(converted.data() + i * sizeof(vertex), &vertex, sizeof(vertex));
+        }
+    }
+
+    return converted;
 }
 
 glm::vec4 parseVector(json_t* vector_node) {
@@ -46,177 +196,220 @@ glm::mat4 parseMatrix(json_t* matrix_node) {
 
     return mat;
 }
-}
 
-ModelLoader::ModelLoader(Renderer* renderer) : _renderer(renderer) {
+ModelLoadData::Material loadMaterial(const std::string& name, const std::string& diffuse_texture) {
+    ModelLoadData::Material mat;
+    mat.name = name;
+    mat.texture_path = std::string("resources/") + diffuse_texture;
+    mat.diffuse_texture = util::decode_texture(mat.texture_path);
 
+    return mat;
 }
-std::unique_ptr<Model> ModelLoader::loadModel(const std::string& model_name) {
-    _currentModel.reset(new Model(_renderer));
 
-    std::stringstream name_stream;
-    name_stream << model_name << ".fom";
-    if (!loadModelData(name_stream.str())) {
-        return nullptr;
+bool loadBinaryMaterials(const ModelChunk& strings, const ModelChunk& materials_chunk, ModelLoadData& data) {
+    uint32_t count;
+    if (!readArrayHeader<FileMaterial>(materials_chunk, "Materials", count)) {
+        return false;
     }
 
-//    auto model_data = _loader->getFileContents(name_stream.str());
-
-    name_stream.str("");
-    name_stream << model_name << ".json";
-    json_error_t err;
-    json_t* metadata = json_load_file(name_stream.str().c_str(), 0, &err);
-    if (!metadata) {
-        fprintf(stderr, "[%s (%d:%d)] %s\n", err.source, err.line, err.column, err.text);
-        return nullptr;
-    }
+    std::vector<ModelLoadData::Material> materials;
+    materials.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        FileMaterial fileMaterial;
+        std::memcpy(&fileMaterial,
+                    materials_chunk.data + sizeof(count) + i * sizeof(fileMaterial),
+                    sizeof(fileMaterial));
+
+        std::string name;
+        std::string diffuse_texture;
+        if (!readString(strings, fileMaterial.name, name)
+            || !readString(strings, fileMaterial.diffuse_texture, diffuse_texture)) {
+            return false;
+        }
 
-    if (!loadMetaData(metadata)) {
-        json_decref(metadata);
-        return nullptr;
+        materials.push_back(loadMaterial(name, diffuse_texture));
     }
-    json_decref(metadata);
 
-    std::unique_ptr<Model> retVal = std::move(_currentModel);
-    _currentModel.reset();
-    return retVal;
+    data.materials = std::move(materials);
+    return true;
 }
 
-bool ModelLoader::loadModelData(const std::string& file_path) {
-    std::ifstream model_data_stream;
-    model_data_stream.open(file_path, std::ios_base::in | std::ios_base::binary);
-    if (!model_data_stream.good()) {
-        fprintf(stderr, "Failed to open model file!\n");
+bool loadBinaryMeshes(const ModelChunk& strings, const ModelChunk& meshes_chunk, ModelLoadData& data) {
+    uint32_t count;
+    if (!readArrayHeader<FileMesh>(meshes_chunk, "Meshes", count)) {
         return false;
     }
 
-    char header_id[8];
-    model_data_stream.read(header_id, sizeof(header_id));
-    if (!model_data_stream.good()) {
-        fprintf(stderr, "Failed to read header of model data!\n");
-        return false;
+    std::vector<MeshData> meshData;
+    meshData.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        FileMesh fileMesh;
+        std::memcpy(&fileMesh, meshes_chunk.data + sizeof(count) + i * sizeof(fileMesh), sizeof(fileMesh));
+
+        MeshData mesh;
+        if (!readString(strings, fileMesh.name, mesh.mesh_name)) {
+            return false;
+        }
+        mesh.material_index = fileMesh.material_index;
+
+        mesh.vertex_offset = (uint32_t) fileMesh.offset;
+        mesh.vertex_count = fileMesh.count;
+        mesh.base_vertex = fileMesh.base_index;
+
+        meshData.push_back(std::move(mesh));
     }
-    if (strncmp(header_id, "FSOMODEL", 8)) {
-        fprintf(stderr, "Header of model is not valid, got %s instead of 'FSOMODEL'!\n", header_id);
+
+    data.meshes = std::move(meshData);
+    return true;
+}
+
+bool loadBinaryNodes(const ModelChunk& strings, const ModelChunk& nodes_chunk, ModelLoadData& data) {
+    uint32_t node_count;
+    uint32_t reference_count;
+    if (nodes_chunk.size < sizeof(node_count) + sizeof(reference_count)) {
+        fprintf(stderr, "Nodes chunk is too small!\n");
         return false;
     }
+    std::memcpy(&node_count, nodes_chunk.data, sizeof(node_count));
+    std::memcpy(&reference_count, nodes_chunk.data + sizeof(node_count), sizeof(reference_count));
 
-    uint32_t version;
-    model_data_stream.read(reinterpret_cast<char*>(&version), sizeof(version));
-    if (!model_data_stream.good()) {
-        fprintf(stderr, "Failed to read header version of model data!\n");
+    auto data_size = nodes_chunk.size - sizeof(node_count) - sizeof(reference_count);
+    if (node_count == 0) {
+        fprintf(stderr, "Model has no root node!\n");
         return false;
     }
-    if (version != SUPPORTED_VERSION) {
-        fprintf(stderr, "Version of model file is not supported!\n");
+    if (data_size / sizeof(FileNode) < node_count
+        || (data_size - node_count * sizeof(FileNode)) / sizeof(uint32_t) < reference_count) {
+        fprintf(stderr, "Nodes chunk is smaller than its number of elements!\n");
         return false;
     }
 
-    std::unique_ptr<BufferObject> vertexObject = _renderer->createBuffer(BufferType::Vertex);
-    std::unique_ptr<BufferObject> indexObject = _renderer->createBuffer(BufferType::Index);
+    auto node_data = nodes_chunk.data + sizeof(node_count) + sizeof(reference_count);
+    auto reference_data = node_data + node_count * sizeof(FileNode);
 
-    bool vertexDataRead = false;
-    bool indexDataRead = false;
-
-    while (true) {
-        uint32_t chunk_type;
-        model_data_stream.read(reinterpret_cast<char*>(&chunk_type), sizeof(chunk_type));
-        if (!model_data_stream.good()) {
-            if (model_data_stream.eof()) {
-                // Expected EOF encountered
-                break;
+    // The nodes are stored in an order where parents come before their children so every parent already exists when a
+    // child is added to it
+    ModelNode rootNode;
+    std::vector<ModelNode*> node_pointers;
+    node_pointers.reserve(node_count);
+    for (uint32_t i = 0; i < node_count; ++i) {
+        FileNode fileNode;
+        std::memcpy(&fileNode, node_data + i * sizeof(fileNode), sizeof(fileNode));
+
+        ModelNode* node;
+        if (i == 0) {
+            if (fileNode.parent != NO_PARENT_NODE) {
+                fprintf(stderr, "The first node must be the root node!\n");
+                return false;
             }
-            fprintf(stderr, "Failed to read chunk_type identifier!\n");
-            return false;
+            node = &rootNode;
+        } else {
+            if (fileNode.parent < 0 || static_cast<uint32_t>(fileNode.parent) >= i) {
+                fprintf(stderr, "Node %u has an invalid parent!\n", i);
+                return false;
+            }
+
+            std::unique_ptr<ModelNode> child_node(new ModelNode());
+            node = child_node.get();
+            node_pointers[fileNode.parent]->child_nodes.push_back(std::move(child_node));
         }
-        uint64_t chunk_length;
-        model_data_stream.read(reinterpret_cast<char*>(&chunk_length), sizeof(chunk_length));
-        if (!model_data_stream.good()) {
-            fprintf(stderr, "Failed to read chunk_type length!\n");
+        node_pointers.push_back(node);
+
+        if (!readString(strings, fileNode.name, node->name)) {
             return false;
         }
+        node->transform = fileNode.transform;
 
-        switch (chunk_type) {
-            case FOURCC('V', 'D', 'A', 'T'): {
-                if (vertexDataRead) {
-                    fprintf(stderr, "Encountered duplicate vertex data chunk!!\n");
-                    return false;
-                }
-
-                std::vector<uint8_t> vertex_data;
-                vertex_data.resize((size_t) chunk_length);
-                model_data_stream.read(reinterpret_cast<char*>(vertex_data.data()), vertex_data.size());
-                if (!model_data_stream.good()) {
-                    fprintf(stderr, "Failed to read vertex data!\n");
-                    return false;
-                }
-
-                vertexObject->setData(vertex_data.data(), (size_t) chunk_length, BufferUsage::Static);
-                vertexDataRead = true;
-
-                break;
-            }
-            case FOURCC('I', 'N', 'D', 'X'): {
-                if (indexDataRead) {
-                    fprintf(stderr, "Encountered duplicate index data chunk!!\n");
-                    return false;
-                }
-
-                std::vector<uint8_t> index_data;
-                index_data.resize((size_t) chunk_length);
-                model_data_stream.read(reinterpret_cast<char*>(index_data.data()), index_data.size());
-                if (!model_data_stream.good()) {
-                    fprintf(stderr, "Failed to read vertex data!\n");
-                    return false;
-                }
+        if (fileNode.first_mesh > reference_count || fileNode.mesh_count > reference_count - fileNode.first_mesh) {
+            fprintf(stderr, "Meshes of node %u are outside of the mesh references!\n", i);
+            return false;
+        }
+        for (uint32_t mesh = 0; mesh < fileNode.mesh_count; ++mesh) {
+            uint32_t mesh_index;
+            std::memcpy(&mesh_index,
+                        reference_data + (fileNode.first_mesh + mesh) * sizeof(mesh_index),
+                        sizeof(mesh_index));
 
-                indexObject->setData(index_data.data(), (size_t) chunk_length, BufferUsage::Static);
-                indexDataRead = true;
+            NodeMeshData mesh_data;
+            mesh_data.mesh_index = mesh_index;
 
-                break;
-            }
-            default:
-                fprintf(stderr, "Skipping unknown chunk_type type %x.\n", chunk_type);
-                model_data_stream.seekg(chunk_length, std::ios_base::cur);
-                break;
+            node->mesh_data.push_back(std::move(mesh_data));
         }
     }
-    _currentModel->setModelData(std::move(vertexObject), std::move(indexObject));
 
+    data.root_node = std::move(rootNode);
     return true;
 }
 
-bool ModelLoader::loadMetaData(json_t* metadata) {
-    auto materials = json_object_get(metadata, "materials");
-    if (!materials) {
-        fprintf(stderr, "Materials key could not be found!\n");
+bool loadBinaryMetaData(const ModelChunk& strings,
+                        const ModelChunk& materials,
+                        const ModelChunk& meshes,
+                        const ModelChunk& nodes,
+                        ModelLoadData& data) {
+    if (!loadBinaryMaterials(strings, materials, data)) {
         return false;
     }
-    if (!loadMaterials(materials)) {
+    if (!loadBinaryMeshes(strings, meshes, data)) {
         return false;
     }
-
-    auto meshes = json_object_get(metadata, "meshes");
-    if (!meshes) {
-        fprintf(stderr, "Meshes key could not be found!\n");
+    if (!loadBinaryNodes(strings, nodes, data)) {
         return false;
     }
-    if (!loadMeshes(meshes)) {
+
+    return true;
+}
+
+bool parseModelNode(json_t* json_node, ModelNode& node_out) {
+    auto name_node = json_object_get(json_node, "name");
+    auto transform_node = json_object_get(json_node, "transform");
+
+    auto meshes_node = json_object_get(json_node, "meshes");
+    auto children_node = json_object_get(json_node, "children");
+
+    if (!transform_node) {
+        fprintf(stderr, "Transform node is missing!\n");
         return false;
     }
 
-    auto root_node = json_object_get(metadata, "root_node");
-    if (!root_node) {
-        fprintf(stderr, "Root node value is missing!\n");
+    if (!meshes_node) {
+        fprintf(stderr, "Meshes node is missing!\n");
+        return false;
+    }
+    if (!children_node) {
+        fprintf(stderr, "Children node is missing!\n");
+        return false;
     }
-    if (!loadNodes(root_node)) {
+
+    node_out.name = name_node == nullptr ? "" : json_string_value(name_node);
+    try {
+        node_out.transform = parseMatrix(transform_node);
+    } catch (const std::runtime_error& e) {
+        fprintf(stderr, "Failed to parse transform matrix: %s\n", e.what());
         return false;
     }
 
+    size_t index;
+    json_t* value;
+    json_array_foreach(meshes_node, index, value) {
+        NodeMeshData node_data;
+        node_data.mesh_index = (size_t) json_integer_value(value);
+
+        node_out.mesh_data.push_back(std::move(node_data));
+    }
+
+    json_array_foreach(children_node, index, value) {
+        std::unique_ptr<ModelNode> child_node(new ModelNode());
+        if (!parseModelNode(value, *child_node)) {
+            return false;
+        }
+        node_out.child_nodes.push_back(std::move(child_node));
+    }
+
     return true;
 }
-bool ModelLoader::loadMaterials(json_t* materials_root) {
-    std::vector<Material> materials;
+
+bool loadMaterials(json_t* materials_root, ModelLoadData& data) {
+    std::vector<ModelLoadData::Material> materials;
 
     size_t index;
     json_t* value;
@@ -229,18 +422,15 @@ bool ModelLoader::loadMaterials(json_t* materials_root) {
             return false;
         }
 
-        Material mat;
-        mat.name = name_node == nullptr ? "" : json_string_value(name_node);
-        mat.diffuse_texture =
-            util::load_texture(_renderer, std::string("resources/") + json_string_value(diffuse_node));
-
-        materials.push_back(std::move(mat));
+        materials.push_back(loadMaterial(name_node == nullptr ? "" : json_string_value(name_node),
+                                         json_string_value(diffuse_node)));
     }
 
-    _currentModel->setMaterials(std::move(materials));
+    data.materials = std::move(materials);
     return true;
 }
-bool ModelLoader::loadMeshes(json_t* meshes_root) {
+
+bool loadMeshes(json_t* meshes_root, ModelLoadData& data) {
     std::vector<MeshData> meshData;
 
     size_t index;
@@ -295,65 +485,536 @@ bool ModelLoader::loadMeshes(json_t* meshes_root) {
         meshData.push_back(std::move(mesh));
     }
 
-    _currentModel->setMeshData(std::move(meshData));
+    data.meshes = std::move(meshData);
     return true;
 }
 
-bool ModelLoader::loadNodes(json_t* nodes_root) {
+bool loadNodes(json_t* nodes_root, ModelLoadData& data) {
     ModelNode rootNode;
     if (!parseModelNode(nodes_root, rootNode)) {
         return false;
     }
 
-    _currentModel->setRootNode(std::move(rootNode));
+    data.root_node = std::move(rootNode);
     return true;
 }
-bool ModelLoader::parseModelNode(json_t* json_node, ModelNode& node_out) {
-    auto name_node = json_object_get(json_node, "name");
-    auto transform_node = json_object_get(json_node, "transform");
 
-    auto meshes_node = json_object_get(json_node, "meshes");
-    auto children_node = json_object_get(json_node, "children");
+bool loadMetaData(json_t* metadata, ModelLoadData& data) {
+    auto materials = json_object_get(metadata, "materials");
+    if (!materials) {
+        fprintf(stderr, "Materials key could not be found!\n");
+        return false;
+    }
+    if (!loadMaterials(materials, data)) {
+        return false;
+    }
 
-    if (!transform_node) {
-        fprintf(stderr, "Transform node is missing!\n");
+    auto meshes = json_object_get(metadata, "meshes");
+    if (!meshes) {
+        fprintf(stderr, "Meshes key could not be found!\n");
+        return false;
+    }
+    if (!loadMeshes(meshes, data)) {
         return false;
     }
 
-    if (!meshes_node) {
-        fprintf(stderr, "Meshes node is missing!\n");
+    auto root_node = json_object_get(metadata, "root_node");
+    if (!root_node) {
+        fprintf(stderr, "Root node value is missing!\n");
+    }
+    if (!loadNodes(root_node, data)) {
         return false;
     }
-    if (!children_node) {
-        fprintf(stderr, "Children node is missing!\n");
+
+    return true;
+}
+
+bool readModelData(const std::string& file_path,
+                   ModelVertexFormat target_format,
+                   ModelLoadData& data,
+                   bool& metadata_loaded) {
+    // The chunks are used directly from the mapped file so the data is only copied once, when it is uploaded into the
+    // geometry heap. Pages of chunks that are skipped are never read.
+    auto& model_file = data.file;
+    if (!model_file.open(file_path)) {
+        fprintf(stderr, "Failed to open model file!\n");
         return false;
     }
 
-    node_out.name = name_node == nullptr ? "" : json_string_value(name_node);
-    try {
-        node_out.transform = parseMatrix(transform_node);
-    } catch (const std::runtime_error& e) {
-        fprintf(stderr, "Failed to parse transform matrix: %s\n", e.what());
+    auto file_data = model_file.getData();
+    auto file_size = model_file.getSize();
+
+    if (file_size < FILE_HEADER_SIZE) {
+        fprintf(stderr, "Failed to read header of model data!\n");
+        return false;
+    }
+    if (strncmp(reinterpret_cast<const char*>(file_data), "FSOMODEL", 8)) {
+        fprintf(stderr,
+                "Header of model is not valid, got %.8s instead of 'FSOMODEL'!\n",
+                reinterpret_cast<const char*>(file_data));
         return false;
     }
 
-    size_t index;
-    json_t* value;
-    json_array_foreach(meshes_node, index, value) {
-        NodeMeshData node_data;
-        node_data.mesh_index = (size_t) json_integer_value(value);
+    uint32_t version;
+    std::memcpy(&version, file_data + 8, sizeof(version));
+    if (version < MIN_SUPPORTED_VERSION || version > MAX_SUPPORTED_VERSION) {
+        fprintf(stderr, "Version of model file is not supported!\n");
+        return false;
+    }
 
-        node_out.mesh_data.push_back(std::move(node_data));
+    // Files without a vertex format chunk were written before packed vertices were added
+    auto vertex_format = ModelVertexFormat::Float;
+
+    auto index_type = IndexType::Short;
+
+    const uint8_t* vertex_data = nullptr;
+    size_t vertex_size = 0;
+    const uint8_t* index_data = nullptr;
+    size_t index_size = 0;
+
+    bool vertexDataRead = false;
+    bool indexDataRead = false;
+
+    ModelChunk strings;
+    ModelChunk materials;
+    ModelChunk meshes;
+    ModelChunk nodes;
+
+    auto compressed_chunks = version >= COMPRESSED_CHUNKS_VERSION;
+    auto chunk_header_size = compressed_chunks ? COMPRESSED_CHUNK_HEADER_SIZE : CHUNK_HEADER_SIZE;
+
+    size_t offset = FILE_HEADER_SIZE;
+    while (offset < file_size) {
+        if (file_size - offset < chunk_header_size) {
+            fprintf(stderr, "Failed to read chunk header!\n");
+            return false;
+        }
+
+        // The chunks are not aligned so the header has to be copied out
+        uint32_t chunk_type;
+        uint32_t compression_value = static_cast<uint32_t>(ChunkCompression::None);
+        uint64_t chunk_length;
+        uint64_t uncompressed_length = 0;
+        auto header = file_data + offset;
+        std::memcpy(&chunk_type, header, sizeof(chunk_type));
+        header += sizeof(chunk_type);
+        if (compressed_chunks) {
+            std::memcpy(&compression_value, header, sizeof(compression_value));
+            header += sizeof(compression_value);
+        }
+        std::memcpy(&chunk_length, header, sizeof(chunk_length));
+        header += sizeof(chunk_length);
+        if (compressed_chunks) {
+            std::memcpy(&uncompressed_length, header, sizeof(uncompressed_length));
+        }
+        offset += chunk_header_size;
+
+        if (chunk_length > file_size - offset) {
+            fprintf(stderr, "Chunk %x is larger than the rest of the file!\n", chunk_type);
+            return false;
+        }
+        auto chunk_data = file_data + offset;
+        offset += static_cast<size_t>(chunk_length);
+
+        auto compression = static_cast<ChunkCompression>(compression_value);
+        if (compression != ChunkCompression::None && isLoadedChunk(chunk_type)) {
+            if (uncompressed_length > (chunk_length + 1) * MAX_COMPRESSION_RATIO) {
+                fprintf(stderr, "Uncompressed size of chunk %x is not valid!\n", chunk_type);
+                return false;
+            }
+
+            // This runs on the loader worker threads. The uncompressed size is known up front so the data is written
+            // into its final buffer without reallocations.
+            data.decompressed_chunks.emplace_back(static_cast<size_t>(uncompressed_length));
+            auto& decompressed = data.decompressed_chunks.back();
+            if (!decompressChunk(chunk_type,
+                                 compression,
+                                 chunk_data,
+                                 static_cast<size_t>(chunk_length),
+                                 decompressed)) {
+                fprintf(stderr, "Failed to decompress chunk %x!\n", chunk_type);
+                return false;
+            }
+
+            chunk_data = decompressed.data();
+            chunk_length = decompressed.size();
+        }
+
+        switch (chunk_type) {
+            case CHUNK_VERTEX_FORMAT: {
+                if (vertexDataRead) {
+                    fprintf(stderr, "Vertex format chunk must come before the vertex data!\n");
+                    return false;
+                }
+
+                uint32_t format_value;
+                if (chunk_length != sizeof(format_value)) {
+                    fprintf(stderr, "Vertex format chunk has an invalid size!\n");
+                    return false;
+                }
+                std::memcpy(&format_value, chunk_data, sizeof(format_value));
+
+                if (format_value != static_cast<uint32_t>(ModelVertexFormat::Float)
+                    && format_value != static_cast<uint32_t>(ModelVertexFormat::Packed)) {
+                    fprintf(stderr, "Unknown vertex format %u!\n", format_value);
+                    return false;
+                }
+                vertex_format = static_cast<ModelVertexFormat>(format_value);
+
+                break;
+            }
+            case CHUNK_VERTEX_DATA: {
+                if (vertexDataRead) {
+                    fprintf(stderr, "Encountered duplicate vertex data chunk!!\n");
+                    return false;
+                }
+
+                vertex_data = chunk_data;
+                vertex_size = static_cast<size_t>(chunk_length);
+
+                vertexDataRead = true;
+
+                break;
+            }
+            case CHUNK_INDEX_DATA:
+            case CHUNK_INDEX_DATA_32: {
+                if (indexDataRead) {
+                    fprintf(stderr, "Encountered duplicate index data chunk!!\n");
+                    return false;
+                }
+
+                index_type = chunk_type == CHUNK_INDEX_DATA_32 ? IndexType::Integer : IndexType::Short;
+
+                index_data = chunk_data;
+                index_size = static_cast<size_t>(chunk_length);
+
+                indexDataRead = true;
+
+                break;
+            }
+            case CHUNK_STRINGS:
+                strings.data = chunk_data;
+                strings.size = static_cast<size_t>(chunk_length);
+                break;
+            case CHUNK_MATERIALS:
+                materials.data = chunk_data;
+                materials.size = static_cast<size_t>(chunk_length);
+                break;
+            case CHUNK_MESHES:
+                meshes.data = chunk_data;
+                meshes.size = static_cast<size_t>(chunk_length);
+                break;
+            case CHUNK_NODES:
+                nodes.data = chunk_data;
+                nodes.size = static_cast<size_t>(chunk_length);
+                break;
+            case CHUNK_SOURCE_HASH:
+                // Only used by the converter, see isLoadedChunk
+                break;
+            default:
+                fprintf(stderr, "Skipping unknown chunk_type type %x.\n", chunk_type);
+                break;
+        }
     }
 
-    json_array_foreach(children_node, index, value) {
-        std::unique_ptr<ModelNode> child_node(new ModelNode());
-        if (!parseModelNode(value, *child_node)) {
+    if (!vertexDataRead || !indexDataRead) {
+        fprintf(stderr, "Model file is missing vertex or index data!\n");
+        return false;
+    }
+
+    if (vertex_size % getModelVertexSize(vertex_format) != 0) {
+        fprintf(stderr, "Vertex data size does not match the vertex format!\n");
+        return false;
+    }
+    if (vertex_format != target_format) {
+        data.converted_vertices = convertVertexData(vertex_data, vertex_size, vertex_format, target_format);
+        vertex_data = data.converted_vertices.data();
+        vertex_size = data.converted_vertices.size();
+    }
+
+    auto index_stride = index_type == IndexType::Integer ? sizeof(uint32_t) : sizeof(uint16_t);
+    if (index_size % index_stride != 0) {
+        fprintf(stderr, "Index data size does not match the index type!\n");
+        return false;
+    }
+
+    data.vertex_data = vertex_data;
+    data.vertex_size = vertex_size;
+    data.index_data = index_data;
+    data.index_size = index_size;
+    data.index_type = index_type;
+
+    if (strings.isPresent() && materials.isPresent() && meshes.isPresent() && nodes.isPresent()) {
+        if (!loadBinaryMetaData(strings, materials, meshes, nodes, data)) {
             return false;
         }
-        node_out.child_nodes.push_back(std::move(child_node));
+        metadata_loaded = true;
     }
 
     return true;
 }
 
+bool validateNodeMeshes(const ModelNode& node, size_t mesh_count) {
+    for (auto& mesh_data : node.mesh_data) {
+        if (mesh_data.mesh_index >= mesh_count) {
+            fprintf(stderr, "Node %s references a mesh which does not exist!\n", node.name.c_str());
+            return false;
+        }
+    }
+    for (auto& child : node.child_nodes) {
+        if (!validateNodeMeshes(*child, mesh_count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The file contents are used for indexing when the model is drawn so every reference has to be checked before that
+bool validateModelData(const ModelLoadData& data, ModelVertexFormat vertex_format) {
+    auto index_stride = data.index_type == IndexType::Integer ? sizeof(uint32_t) : sizeof(uint16_t);
+    auto index_count = static_cast<uint64_t>(data.index_size / index_stride);
+    auto vertex_count = static_cast<uint64_t>(data.vertex_size / getModelVertexSize(vertex_format));
+
+    for (auto& mesh : data.meshes) {
+        if (mesh.material_index >= data.materials.size()) {
+            fprintf(stderr, "Mesh %s references a material which does not exist!\n", mesh.mesh_name.c_str());
+            return false;
+        }
+        if (static_cast<uint64_t>(mesh.vertex_offset) + mesh.vertex_count > index_count) {
+            fprintf(stderr, "Indices of mesh %s are outside of the index data!\n", mesh.mesh_name.c_str());
+            return false;
+        }
+
+        // Checking only the base vertex is not enough since every index is added to it
+        uint32_t max_index = 0;
+        for (uint32_t i = 0; i < mesh.vertex_count; ++i) {
+            auto index_ptr = data.index_data + (static_cast<size_t>(mesh.vertex_offset) + i) * index_stride;
+            if (data.index_type == IndexType::Integer) {
+                uint32_t index;
+                std::memcpy(&index, index_ptr, sizeof(index));
+                max_index = std::max(max_index, index);
+            } else {
+                uint16_t index;
+                std::memcpy(&index, index_ptr, sizeof(index));
+                max_index = std::max(max_index, static_cast<uint32_t>(index));
+            }
+        }
+        if (mesh.vertex_count > 0 && static_cast<uint64_t>(mesh.base_vertex) + max_index >= vertex_count) {
+            fprintf(stderr, "Vertices of mesh %s are outside of the vertex data!\n", mesh.mesh_name.c_str());
+            return false;
+        }
+    }
+
+    return validateNodeMeshes(data.root_node, data.meshes.size());
+}
+
+// Reads everything except the GPU resources, this may be called from any thread
+std::unique_ptr<ModelLoadData> readModel(const std::string& model_name, ModelVertexFormat target_format) {
+    std::unique_ptr<ModelLoadData> data(new ModelLoadData());
+
+    std::stringstream name_stream;
+    name_stream << model_name << ".fom";
+    bool metadata_loaded = false;
+    if (!readModelData(name_stream.str(), target_format, *data, metadata_loaded)) {
+        return nullptr;
+    }
+
+    // Otherwise the render thread would have to wait for the disk when the geometry is uploaded
+    touchPages(data->vertex_data, data->vertex_size);
+    touchPages(data->index_data, data->index_size);
+
+    if (metadata_loaded) {
+        if (!validateModelData(*data, target_format)) {
+            return nullptr;
+        }
+        return data;
+    }
+
+    name_stream.str("");
+    name_stream << model_name << ".json";
+    json_error_t err;
+    json_t* metadata = json_load_file(name_stream.str().c_str(), 0, &err);
+    if (!metadata) {
+        fprintf(stderr, "[%s (%d:%d)] %s\n", err.source, err.line, err.column, err.text);
+        return nullptr;
+    }
+
+    if (!loadMetaData(metadata, *data)) {
+        json_decref(metadata);
+        return nullptr;
+    }
+    json_decref(metadata);
+
+    if (!validateModelData(*data, target_format)) {
+        return nullptr;
+    }
+
+    return data;
+}
+}
+
+ModelLoadHandle::ModelLoadHandle() {
+}
+
+ModelLoadHandle::ModelLoadHandle(const std::shared_ptr<State>& state) : _state(state) {
+}
+
+bool ModelLoadHandle::isValid() const {
+    return _state != nullptr;
+}
+
+ModelLoadStatus ModelLoadHandle::getStatus() const {
+    Assertion(isValid(), "Invalid model load handle!");
+
+    return _state->status;
+}
+
+bool ModelLoadHandle::isDone() const {
+    return getStatus() != ModelLoadStatus::Loading;
+}
+
+std::unique_ptr<Model> ModelLoadHandle::takeModel() {
+    Assertion(isValid(), "Invalid model load handle!");
+
+    return std::move(_state->model);
+}
+
+ModelLoader::PendingLoad::PendingLoad() : step(FinalizeStep::Geometry) {
+}
+
+ModelLoader::ModelLoader(Renderer* renderer,
+                         WorkerPool* workerPool,
+                         GeometryHeap* geometryHeap,
+                         ModelVertexFormat vertexFormat)
+    : _renderer(renderer), _workerPool(workerPool), _geometryHeap(geometryHeap), _vertexFormat(vertexFormat),
+      _finalizeBudget(DEFAULT_FINALIZE_BUDGET) {
+
+}
+
+ModelLoader::~ModelLoader() {
+    // The futures of the worker pool do not wait for their job so this only discards the results
+    _pendingLoads.clear();
+}
+
+std::unique_ptr<Model> ModelLoader::loadModel(const std::string& model_name) {
+    auto data = readModel(model_name, _vertexFormat);
+    if (!data) {
+        return nullptr;
+    }
+
+    return finalizeModel(*data);
+}
+
+ModelLoadHandle ModelLoader::loadModelAsync(const std::string& model_name) {
+    PendingLoad load;
+    load.state = std::make_shared<ModelLoadHandle::State>();
+    auto vertexFormat = _vertexFormat;
+    load.data = _workerPool->submit([model_name, vertexFormat]() { return readModel(model_name, vertexFormat); });
+
+    ModelLoadHandle handle(load.state);
+    _pendingLoads.push_back(std::move(load));
+
+    return handle;
+}
+
+void ModelLoader::processLoadedModels() {
+    auto start = std::chrono::steady_clock::now();
+
+    auto iter = _pendingLoads.begin();
+    while (iter != _pendingLoads.end()) {
+        if (iter->data.valid()) {
+            if (iter->data.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++iter;
+                continue;
+            }
+
+            iter->loaded = iter->data.get();
+            if (!iter->loaded) {
+                iter->state->status = ModelLoadStatus::Failed;
+                iter = _pendingLoads.erase(iter);
+                continue;
+            }
+            iter->model.reset(new Model(_renderer));
+        }
+
+        iter->step = finalizeStep(*iter->model, *iter->loaded, iter->step);
+
+        if (iter->step == FinalizeStep::Done) {
+            iter->state->model = std::move(iter->model);
+            iter->state->status = ModelLoadStatus::Loaded;
+
+            iter = _pendingLoads.erase(iter);
+        }
+
+        if (std::chrono::steady_clock::now() - start >= _finalizeBudget) {
+            return;
+        }
+    }
+}
+
+bool ModelLoader::hasPendingLoads() const {
+    return !_pendingLoads.empty();
+}
+
+void ModelLoader::setFinalizeBudget(std::chrono::microseconds budget) {
+    _finalizeBudget = budget;
+}
+
+std::unique_ptr<Model> ModelLoader::finalizeModel(ModelLoadData& data) {
+    std::unique_ptr<Model> model(new Model(_renderer));
+
+    auto step = FinalizeStep::Geometry;
+    while (step != FinalizeStep::Done) {
+        step = finalizeStep(*model, data, step);
+    }
+
+    return model;
+}
+
+ModelLoader::FinalizeStep ModelLoader::finalizeStep(Model& model, ModelLoadData& data, FinalizeStep step) {
+    switch (step) {
+        case FinalizeStep::Geometry: {
+            auto geometry = _geometryHeap->allocate(data.vertex_data,
+                                                    data.vertex_size,
+                                                    data.index_data,
+                                                    data.index_size,
+                                                    data.index_type);
+            model.setModelData(_geometryHeap, geometry);
+
+            return FinalizeStep::Materials;
+        }
+        case FinalizeStep::Materials: {
+            std::vector<Material> materials;
+            materials.reserve(data.materials.size());
+            for (auto& material : data.materials) {
+                Material mat;
+                mat.name = material.name;
+                mat.diffuse_texture = _renderer->createTexture();
+                mat.diffuse_texture->setDebugName(material.texture_path);
+
+                // Textures are the largest part of a model so they are uploaded over multiple frames
+                if (material.diffuse_texture) {
+                    auto uploads = _renderer->getUploadQueue();
+                    mat.diffuse_upload = uploads->uploadTexture(mat.diffuse_texture.get(),
+                                                                *material.diffuse_texture,
+                                                                util::get_texture_filter_properties());
+                }
+
+                materials.push_back(std::move(mat));
+            }
+            model.setMaterials(std::move(materials));
+
+            return FinalizeStep::Nodes;
+        }
+        case FinalizeStep::Nodes:
+            model.setMeshData(std::move(data.meshes));
+            model.setRootNode(std::move(data.root_node));
+
+            return FinalizeStep::Done;
+        case FinalizeStep::Done:
+            break;
+    }
+
+    Assertion(false, "Model is already finalized!");
+    return FinalizeStep::Done;
+}
@@ -1,27 +1,118 @@
 #pragma once
 
 #include <renderer/Renderer.hpp>
-#include <jansson.h>
 #include "Model.hpp"
 
+#include <util/WorkerPool.hpp>
+
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+
+struct ModelLoadData;
+
+enum class ModelLoadStatus {
+    Loading,
+    Loaded,
+    Failed
+};
+
+// Refers to a model which is loaded in the background, copies of a handle refer to the same model. The status only
+// changes in ModelLoader::processLoadedModels so the handle should only be used on the render thread.
+class ModelLoadHandle {
+    friend class ModelLoader;
+
+    struct State {
+        ModelLoadStatus status;
+        std::unique_ptr<Model> model;
+
+        State() : status(ModelLoadStatus::Loading) {
+        }
+    };
+
+    std::shared_ptr<State> _state;
+
+    explicit ModelLoadHandle(const std::shared_ptr<State>& state);
+ public:
+    // Creates a handle which does not refer to a model
+    ModelLoadHandle();
+
+    bool isValid() const;
+
+    ModelLoadStatus getStatus() const;
+
+    bool isDone() const;
+
+    // Transfers the ownership of the model to the caller. Returns nullptr if the model is not loaded yet, failed to
+    // load or was already taken.
+    std::unique_ptr<Model> takeModel();
+};
+
 class ModelLoader {
-    Renderer* _renderer;
+    // Finalizing a model is split into steps so that processLoadedModels can check its budget between them
+    enum class FinalizeStep {
+        Geometry,
+        Materials,
+        Nodes,
+        Done
+    };
 
-    std::unique_ptr<Model> _currentModel;
+    struct PendingLoad {
+        // Becomes invalid once the data has been read, the model is then finalized one step at a time
+        std::future<std::unique_ptr<ModelLoadData>> data;
+        std::shared_ptr<ModelLoadHandle::State> state;
 
-    bool loadMetaData(json_t* metadata);
+        std::unique_ptr<ModelLoadData> loaded;
+        std::unique_ptr<Model> model;
+        FinalizeStep step;
 
-    bool loadMaterials(json_t* materials_root);
+        // Defined in the source file since ModelLoadData is incomplete here
+        PendingLoad();
+    };
 
-    bool loadMeshes(json_t* meshes_root);
+    Renderer* _renderer;
+    WorkerPool* _workerPool;
+    GeometryHeap* _geometryHeap;
+    ModelVertexFormat _vertexFormat;
 
-    bool loadNodes(json_t* nodes_root);
+    std::deque<PendingLoad> _pendingLoads;
+    std::chrono::microseconds _finalizeBudget;
 
-    bool parseModelNode(json_t* json_node, ModelNode & node_out);
+    // Creates the GPU resources of the model. Must be called on the render thread.
+    std::unique_ptr<Model> finalizeModel(ModelLoadData& data);
 
-    bool loadModelData(const std::string& file_path);
+    // Executes a single step of finalizeModel and returns the next one
+    FinalizeStep finalizeStep(Model& model, ModelLoadData& data, FinalizeStep step);
  public:
-    ModelLoader(Renderer* renderer);
+    // The geometry of the loaded models is stored in the heap so it has to outlive the models. The heap has to use the
+    // vertex input state of the specified format, models with a different format are converted while loading. The
+    // models are read on the worker pool which has to outlive the loader. Reading a model may take a long time so the
+    // pool should not be used for jobs that have to be done within a frame.
+    ModelLoader(Renderer* renderer, WorkerPool* workerPool, GeometryHeap* geometryHeap, ModelVertexFormat vertexFormat);
+    // Discards the models which are still being read, the jobs do not reference the loader so they may finish later
+    ~ModelLoader();
 
+    ModelLoader(const ModelLoader&) = delete;
+    ModelLoader& operator=(const ModelLoader&) = delete;
+
+    // Loads the model on the calling thread which must be the render thread. The textures are still uploaded over
+    // multiple frames through the upload queue of the renderer.
     std::unique_ptr<Model> loadModel(const std::string& model_name);
+
+    // Reads the model file, parses the metadata and decodes the textures on the worker pool. Only the creation of the
+    // GPU resources is left for processLoadedModels.
+    ModelLoadHandle loadModelAsync(const std::string& model_name);
+
+    // Creates the GPU resources of the models whose data has been read, in the order they were requested, until the
+    // time budget is used up. The budget is checked between the steps of a model so a model may be finalized over
+    // multiple calls. At least one step is executed per call if a model is ready. Must be called regularly on the
+    // render thread, e.g. once per frame.
+    void processLoadedModels();
+
+    // Returns true if there are models which have not been finalized yet
+    bool hasPendingLoads() const;
+
+    // The default budget is 2ms per call
+    void setFinalizeBudget(std::chrono::microseconds budget);
 };
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
 
 #include "Enums.hpp"
 
@@ -21,7 +22,8 @@ enum class BufferType {
 enum class BufferUsage {
     Static,
     Dynamic,
-    Streaming
+    Streaming,
+    PersistentStreaming // The buffer stays mapped for its whole lifetime, see BufferObject::getPersistentPointer
 };
 
 enum class UpdateFlags {
@@ -38,6 +40,7 @@ enum class BufferMapFlags {
     Read = 1 << 0,
     Write = 1 << 1,
     InvalidateData = 1 << 2,
+    Unsynchronized = 1 << 3, // The caller guarantees that the GPU does not use the mapped range anymore
 };
 template<>
 struct BitOperationsTag<BufferMapFlags> {
@@ -58,6 +61,18 @@ public:
     virtual void* map(size_t offset, size_t size, BufferMapFlags flags) = 0;
 
     virtual bool unmap() = 0;
+
+    // Returns the CPU pointer of a buffer which was created with BufferUsage::PersistentStreaming. The pointer stays
+    // the same until setData is called again so it can be written to without mapping the buffer. The caller has to make
+    // sure that the GPU does not use a range anymore before writing to it.
+    virtual void* getPersistentPointer() = 0;
+
+    // Makes the data written through the persistent pointer visible to the GPU. Has to be called after writing and
+    // before the range is used by a draw call.
+    virtual void flushPersistentRange(size_t offset, size_t size) = 0;
+
+    // The name is shown in graphics debuggers and in the memory statistics of the renderer
+    virtual void setDebugName(const std::string& name) = 0;
 };
 
 #endif //PROJECT_VERTEXBUFFER_H
@@ -14,10 +14,21 @@ struct BitOperationsTag<ClearTarget> {
     static constexpr bool value = true;
 };
 
+enum class CommandBufferMode {
+    Immediate, // Commands are executed while they are recorded
+    Deferred // Commands are only recorded and need to be executed by submitting the buffer to the renderer
+};
+
 class CommandBuffer {
  public:
     virtual ~CommandBuffer() {}
 
+    virtual CommandBufferMode getMode() const = 0;
+
+    // Discards all recorded commands. The memory used for storing them is kept so the buffer can be reused without
+    // allocating again.
+    virtual void reset() = 0;
+
     virtual void clear(const glm::vec4& color, ClearTarget target) = 0;
 
     virtual void bindPipeline(PointerWrapper<PipelineState> pipeline) = 0;
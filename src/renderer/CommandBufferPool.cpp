@@ -0,0 +1,50 @@
+//
+//
+
+#include "CommandBufferPool.hpp"
+#include "Renderer.hpp"
+
+#include <util/Assertion.hpp>
+
+CommandBufferPool::CommandBufferPool(Renderer* renderer) : _renderer(renderer) {
+}
+
+std::vector<CommandBuffer*>& CommandBufferPool::getFreeList(CommandBufferMode mode) {
+    switch (mode) {
+        case CommandBufferMode::Immediate:
+            return _freeImmediateBuffers;
+        case CommandBufferMode::Deferred:
+            return _freeDeferredBuffers;
+    }
+    return _freeImmediateBuffers;
+}
+
+CommandBuffer* CommandBufferPool::acquire(CommandBufferMode mode) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto& freeList = getFreeList(mode);
+    if (!freeList.empty()) {
+        auto buffer = freeList.back();
+        freeList.pop_back();
+        return buffer;
+    }
+
+    _buffers.push_back(_renderer->createCommandBuffer(mode));
+    auto buffer = _buffers.back().get();
+
+    // Reserve the space in the free list now so that releasing the buffer never has to allocate
+    _freeImmediateBuffers.reserve(_buffers.size());
+    _freeDeferredBuffers.reserve(_buffers.size());
+
+    return buffer;
+}
+
+void CommandBufferPool::release(CommandBuffer* buffer) {
+    Assertion(buffer != nullptr, "Invalid command buffer passed!");
+
+    // Resetting does not need the lock since the buffer is not shared at this point
+    buffer->reset();
+
+    std::lock_guard<std::mutex> guard(_lock);
+    getFreeList(buffer->getMode()).push_back(buffer);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CommandBuffer.hpp"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Renderer;
+
+// Keeps command buffers alive across frames so that their storage can be reused. Released buffers are reset and handed
+// out again by the next acquire call of the same mode. Both functions may be called from any thread.
+class CommandBufferPool {
+    Renderer* _renderer;
+
+    std::mutex _lock;
+
+    std::vector<std::unique_ptr<CommandBuffer>> _buffers;
+    std::vector<CommandBuffer*> _freeImmediateBuffers;
+    std::vector<CommandBuffer*> _freeDeferredBuffers;
+
+    std::vector<CommandBuffer*>& getFreeList(CommandBufferMode mode);
+ public:
+    explicit CommandBufferPool(Renderer* renderer);
+
+    CommandBuffer* acquire(CommandBufferMode mode);
+
+    void release(CommandBuffer* buffer);
+};
@@ -0,0 +1,136 @@
+//
+//
+
+#include "GeometryHeap.hpp"
+#include "Renderer.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <algorithm>
+
+namespace {
+size_t getIndexSize(IndexType type) {
+    switch (type) {
+        case IndexType::Short:
+            return sizeof(uint16_t);
+        case IndexType::Integer:
+            return sizeof(uint32_t);
+    }
+    return sizeof(uint16_t);
+}
+}
+
+GeometryHeap::GeometryHeap(Renderer* renderer,
+                           const VertexInputStateProperties& vertexInput,
+                           size_t pageVertexSize,
+                           size_t pageIndexSize)
+    : _renderer(renderer), _vertexInput(vertexInput), _pageVertexSize(pageVertexSize), _pageIndexSize(pageIndexSize) {
+    Assertion(_vertexInput.bufferBindings.size() == 1, "The geometry heap only supports a single vertex buffer!");
+
+    _vertexStride = _vertexInput.bufferBindings.front().stride;
+}
+
+GeometryHeap::Page* GeometryHeap::createPage(IndexType indexType, size_t minVertexSize, size_t minIndexSize) {
+    // Data which is larger than a page gets a page of its own
+    auto vertexSize = std::max(_pageVertexSize, minVertexSize);
+    auto indexSize = std::max(_pageIndexSize, minIndexSize);
+
+    std::unique_ptr<Page> page(new Page(indexType, vertexSize, indexSize));
+
+    page->vertex_buffer = _renderer->createBuffer(BufferType::Vertex);
+    page->vertex_buffer->setDebugName("Geometry heap vertices");
+    page->vertex_buffer->setData(nullptr, vertexSize, BufferUsage::Static);
+
+    page->index_buffer = _renderer->createBuffer(BufferType::Index);
+    page->index_buffer->setDebugName("Geometry heap indices");
+    page->index_buffer->setData(nullptr, indexSize, BufferUsage::Static);
+
+    VertexArrayProperties vaoProps;
+    vaoProps.addBufferBinding(_vertexInput.bufferBindings.front().bufferBinding, page->vertex_buffer.get());
+
+    vaoProps.indexBuffer = page->index_buffer.get();
+    vaoProps.indexOffset = 0;
+    vaoProps.indexType = indexType;
+
+    page->vertex_array = _renderer->createVertexArrayObject(_vertexInput, vaoProps);
+
+    _pages.push_back(std::move(page));
+    return _pages.back().get();
+}
+
+GeometryAllocation GeometryHeap::allocate(const void* vertexData,
+                                          size_t vertexSize,
+                                          const void* indexData,
+                                          size_t indexSize,
+                                          IndexType indexType) {
+    auto indexStride = getIndexSize(indexType);
+
+    Assertion(vertexSize % _vertexStride == 0, "Vertex data size is not a multiple of the vertex size!");
+    Assertion(indexSize % indexStride == 0, "Index data size is not a multiple of the index size!");
+
+    GeometryAllocation allocation;
+    allocation.vertex_size = vertexSize;
+    allocation.index_size = indexSize;
+    allocation.index_type = indexType;
+
+    for (size_t i = 0; i < _pages.size(); ++i) {
+        auto& page = _pages[i];
+
+        if (page->index_type != indexType) {
+            continue;
+        }
+        if (page->vertex_allocator.getFreeSize() < vertexSize || page->index_allocator.getFreeSize() < indexSize) {
+            continue;
+        }
+
+        // Vertices are aligned to the stride so that the base vertex is a whole number
+        auto vertexOffset = page->vertex_allocator.allocate(vertexSize, _vertexStride);
+        if (vertexOffset == FreeListAllocator::INVALID_OFFSET) {
+            continue;
+        }
+        auto indexOffset = page->index_allocator.allocate(indexSize, indexStride);
+        if (indexOffset == FreeListAllocator::INVALID_OFFSET) {
+            page->vertex_allocator.free(vertexOffset, vertexSize);
+            continue;
+        }
+
+        allocation.page = i;
+        allocation.vertex_offset = vertexOffset;
+        allocation.index_offset = indexOffset;
+        break;
+    }
+
+    if (!allocation.isValid()) {
+        auto page = createPage(indexType, vertexSize, indexSize);
+
+        allocation.page = _pages.size() - 1;
+        allocation.vertex_offset = page->vertex_allocator.allocate(vertexSize, _vertexStride);
+        allocation.index_offset = page->index_allocator.allocate(indexSize, indexStride);
+    }
+
+    allocation.base_vertex = static_cast<uint32_t>(allocation.vertex_offset / _vertexStride);
+    allocation.first_index = static_cast<uint32_t>(allocation.index_offset / indexStride);
+
+    auto& page = _pages[allocation.page];
+    page->vertex_buffer->updateData(vertexData, allocation.vertex_offset, vertexSize, UpdateFlags::None);
+    page->index_buffer->updateData(indexData, allocation.index_offset, indexSize, UpdateFlags::None);
+
+    return allocation;
+}
+
+void GeometryHeap::free(GeometryAllocation& allocation) {
+    Assertion(allocation.isValid(), "Tried to free an invalid geometry allocation!");
+    Assertion(allocation.page < _pages.size(), "Geometry allocation does not belong to this heap!");
+
+    auto& page = _pages[allocation.page];
+    page->vertex_allocator.free(allocation.vertex_offset, allocation.vertex_size);
+    page->index_allocator.free(allocation.index_offset, allocation.index_size);
+
+    allocation = GeometryAllocation();
+}
+
+VertexArrayObject* GeometryHeap::getVertexArrayObject(const GeometryAllocation& allocation) {
+    Assertion(allocation.isValid(), "Geometry allocation is not valid!");
+
+    return _pages[allocation.page]->vertex_array.get();
+}
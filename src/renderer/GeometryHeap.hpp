@@ -0,0 +1,94 @@
+#pragma once
+
+#include "BufferObject.hpp"
+#include "VertexLayout.hpp"
+
+#include <util/FreeListAllocator.hpp>
+
+#include <memory>
+#include <vector>
+
+class Renderer;
+
+// A range of vertex and index data inside a GeometryHeap
+struct GeometryAllocation {
+    size_t page;
+
+    size_t vertex_offset;
+    size_t vertex_size;
+    size_t index_offset;
+    size_t index_size;
+    IndexType index_type;
+
+    // The position of the allocation in vertices and indices. These have to be added to the base vertex and the index
+    // offset of every draw call which uses this allocation.
+    uint32_t base_vertex;
+    uint32_t first_index;
+
+    GeometryAllocation()
+        : page(SIZE_MAX), vertex_offset(0), vertex_size(0), index_offset(0), index_size(0),
+          index_type(IndexType::Short), base_vertex(0), first_index(0) {
+    }
+
+    bool isValid() const {
+        return page != SIZE_MAX;
+    }
+};
+
+// Stores the geometry of many meshes with the same vertex format in a few large vertex and index buffers. Every page
+// consists of one vertex buffer, one index buffer and a vertex array object which uses them so all allocations in the
+// same page can be drawn without switching the vertex array object. A new page is created if no existing page has
+// enough free space. Since the index type is part of the vertex array object every page only contains indices of one
+// type.
+class GeometryHeap {
+    struct Page {
+        std::unique_ptr<BufferObject> vertex_buffer;
+        std::unique_ptr<BufferObject> index_buffer;
+        std::unique_ptr<VertexArrayObject> vertex_array;
+        IndexType index_type;
+
+        FreeListAllocator vertex_allocator;
+        FreeListAllocator index_allocator;
+
+        Page(IndexType indexType, size_t vertexSize, size_t indexSize)
+            : index_type(indexType), vertex_allocator(vertexSize), index_allocator(indexSize) {
+        }
+    };
+
+    Renderer* _renderer;
+
+    VertexInputStateProperties _vertexInput;
+
+    size_t _vertexStride;
+
+    size_t _pageVertexSize;
+    size_t _pageIndexSize;
+
+    std::vector<std::unique_ptr<Page>> _pages;
+
+    Page* createPage(IndexType indexType, size_t minVertexSize, size_t minIndexSize);
+ public:
+    GeometryHeap(Renderer* renderer,
+                 const VertexInputStateProperties& vertexInput,
+                 size_t pageVertexSize,
+                 size_t pageIndexSize);
+
+    // Copies the data into the heap. The vertex data has to use the vertex format of the heap.
+    GeometryAllocation allocate(const void* vertexData,
+                                size_t vertexSize,
+                                const void* indexData,
+                                size_t indexSize,
+                                IndexType indexType);
+
+    void free(GeometryAllocation& allocation);
+
+    VertexArrayObject* getVertexArrayObject(const GeometryAllocation& allocation);
+
+    const VertexInputStateProperties& getVertexInputState() const {
+        return _vertexInput;
+    }
+
+    size_t getNumPages() const {
+        return _pages.size();
+    }
+};
@@ -0,0 +1,289 @@
+//
+//
+
+#include "MemoryTracker.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <algorithm>
+
+namespace {
+void addToUsage(MemoryUsage& usage, size_t size) {
+    usage.current_bytes += size;
+    ++usage.current_count;
+
+    if (usage.current_bytes > usage.peak_bytes) {
+        usage.peak_bytes = usage.current_bytes;
+    }
+}
+void removeFromUsage(MemoryUsage& usage, size_t size) {
+    Assertion(usage.current_bytes >= size, "Memory usage would become negative!");
+    Assertion(usage.current_count > 0, "Memory usage would become negative!");
+
+    usage.current_bytes -= size;
+    --usage.current_count;
+}
+template<typename TKey>
+MemoryUsage findUsage(const std::map<TKey, MemoryUsage>& map, const TKey& key) {
+    auto iter = map.find(key);
+    if (iter == map.end()) {
+        return MemoryUsage();
+    }
+    return iter->second;
+}
+template<typename TKey>
+void resetMapPeaks(std::map<TKey, MemoryUsage>& map) {
+    for (auto& entry : map) {
+        entry.second.peak_bytes = entry.second.current_bytes;
+    }
+}
+}
+
+MemoryTracker::MemoryTracker() : _nextId(1) {
+}
+
+void MemoryTracker::addUsage(const MemoryResourceInfo& info) {
+    if (info.size == 0) {
+        return;
+    }
+
+    addToUsage(_totalUsage, info.size);
+    addToUsage(_categoryUsage[info.category], info.size);
+
+    if (info.category == MemoryCategory::Buffer) {
+        addToUsage(_bufferUsage[std::make_pair(info.buffer_type, info.buffer_usage)], info.size);
+    } else {
+        addToUsage(_textureFormatUsage[info.format], info.size);
+        addToUsage(_textureTargetUsage[info.target], info.size);
+        addToUsage(_textureLevelUsage[info.levels], info.size);
+    }
+}
+
+void MemoryTracker::removeUsage(const MemoryResourceInfo& info) {
+    if (info.size == 0) {
+        return;
+    }
+
+    removeFromUsage(_totalUsage, info.size);
+    removeFromUsage(_categoryUsage[info.category], info.size);
+
+    if (info.category == MemoryCategory::Buffer) {
+        removeFromUsage(_bufferUsage[std::make_pair(info.buffer_type, info.buffer_usage)], info.size);
+    } else {
+        removeFromUsage(_textureFormatUsage[info.format], info.size);
+        removeFromUsage(_textureTargetUsage[info.target], info.size);
+        removeFromUsage(_textureLevelUsage[info.levels], info.size);
+    }
+}
+
+MemoryResourceInfo& MemoryTracker::getResource(MemoryResourceId id) {
+    auto iter = _resources.find(id);
+    Assertion(iter != _resources.end(), "Invalid memory resource id specified!");
+
+    return iter->second;
+}
+
+MemoryResourceId MemoryTracker::registerResource(MemoryCategory category) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    MemoryResourceInfo info;
+    info.id = _nextId++;
+    info.category = category;
+
+    _resources.insert(std::make_pair(info.id, info));
+
+    return info.id;
+}
+
+void MemoryTracker::unregisterResource(MemoryResourceId id) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    removeUsage(getResource(id));
+    _resources.erase(id);
+}
+
+void MemoryTracker::setBufferAllocation(MemoryResourceId id, BufferType type, BufferUsage usage, size_t size) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto& info = getResource(id);
+    Assertion(info.category == MemoryCategory::Buffer, "Resource is not a buffer!");
+
+    removeUsage(info);
+
+    info.buffer_type = type;
+    info.buffer_usage = usage;
+    info.size = size;
+
+    addUsage(info);
+}
+
+void MemoryTracker::setTextureAllocation(MemoryResourceId id,
+                                         gli::format format,
+                                         gli::target target,
+                                         size_t levels,
+                                         size_t size) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto& info = getResource(id);
+    Assertion(info.category != MemoryCategory::Buffer, "Resource is not a texture!");
+
+    removeUsage(info);
+
+    info.format = format;
+    info.target = target;
+    info.levels = levels;
+    info.size = size;
+
+    addUsage(info);
+}
+
+void MemoryTracker::setCategory(MemoryResourceId id, MemoryCategory category) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto& info = getResource(id);
+    Assertion((info.category == MemoryCategory::Buffer) == (category == MemoryCategory::Buffer),
+              "Buffers can not be changed into textures or the other way around!");
+
+    removeUsage(info);
+    info.category = category;
+    addUsage(info);
+}
+
+void MemoryTracker::setName(MemoryResourceId id, const std::string& name) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    getResource(id).name = name;
+}
+
+MemoryUsage MemoryTracker::getTotalUsage() const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return _totalUsage;
+}
+
+MemoryUsage MemoryTracker::getCategoryUsage(MemoryCategory category) const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return findUsage(_categoryUsage, category);
+}
+
+MemoryUsage MemoryTracker::getBufferUsage(BufferType type, BufferUsage usage) const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return findUsage(_bufferUsage, std::make_pair(type, usage));
+}
+
+MemoryUsage MemoryTracker::getTextureFormatUsage(gli::format format) const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return findUsage(_textureFormatUsage, format);
+}
+
+MemoryUsage MemoryTracker::getTextureTargetUsage(gli::target target) const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return findUsage(_textureTargetUsage, target);
+}
+
+MemoryUsage MemoryTracker::getTextureLevelUsage(size_t levels) const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return findUsage(_textureLevelUsage, levels);
+}
+
+std::vector<MemoryResourceInfo> MemoryTracker::getResources() const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    std::vector<MemoryResourceInfo> resources;
+    resources.reserve(_resources.size());
+    for (auto& entry : _resources) {
+        resources.push_back(entry.second);
+    }
+
+    return resources;
+}
+
+void MemoryTracker::resetPeaks() {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    _totalUsage.peak_bytes = _totalUsage.current_bytes;
+    resetMapPeaks(_categoryUsage);
+    resetMapPeaks(_bufferUsage);
+    resetMapPeaks(_textureFormatUsage);
+    resetMapPeaks(_textureTargetUsage);
+    resetMapPeaks(_textureLevelUsage);
+}
+
+size_t MemoryTracker::computeTextureSize(gli::format format,
+                                         gli::target target,
+                                         const gli::extent3d& extent,
+                                         size_t levels) {
+    // Array layers and cube faces are not part of the mipmap chain so they are split off of the extent
+    gli::extent3d levelExtent = glm::max(extent, gli::extent3d(1));
+    size_t layers = 1;
+    switch (target) {
+        case gli::TARGET_1D:
+            levelExtent.y = 1;
+            levelExtent.z = 1;
+            break;
+        case gli::TARGET_1D_ARRAY:
+            layers = (size_t) levelExtent.y;
+            levelExtent.y = 1;
+            levelExtent.z = 1;
+            break;
+        case gli::TARGET_2D:
+            levelExtent.z = 1;
+            break;
+        case gli::TARGET_2D_ARRAY:
+            layers = (size_t) levelExtent.z;
+            levelExtent.z = 1;
+            break;
+        case gli::TARGET_CUBE:
+            layers = 6;
+            levelExtent.z = 1;
+            break;
+        case gli::TARGET_CUBE_ARRAY:
+            layers = 6 * (size_t) levelExtent.z;
+            levelExtent.z = 1;
+            break;
+        default:
+            break;
+    }
+
+    auto blockExtent = gli::block_extent(format);
+    auto blockSize = gli::block_size(format);
+
+    size_t size = 0;
+    for (size_t level = 0; level < std::max(levels, (size_t) 1); ++level) {
+        auto blocks = (levelExtent + blockExtent - 1) / blockExtent;
+        size += (size_t) blocks.x * blocks.y * blocks.z * blockSize;
+
+        levelExtent = glm::max(levelExtent / 2, gli::extent3d(1));
+    }
+
+    return size * layers;
+}
+
+TrackedMemory::TrackedMemory(MemoryTracker* tracker, MemoryCategory category)
+    : _tracker(tracker), _id(tracker->registerResource(category)) {
+}
+
+TrackedMemory::~TrackedMemory() {
+    _tracker->unregisterResource(_id);
+}
+
+void TrackedMemory::setBufferAllocation(BufferType type, BufferUsage usage, size_t size) {
+    _tracker->setBufferAllocation(_id, type, usage, size);
+}
+
+void TrackedMemory::setTextureAllocation(gli::format format, gli::target target, size_t levels, size_t size) {
+    _tracker->setTextureAllocation(_id, format, target, levels, size);
+}
+
+void TrackedMemory::setCategory(MemoryCategory category) {
+    _tracker->setCategory(_id, category);
+}
+
+void TrackedMemory::setName(const std::string& name) {
+    _tracker->setName(_id, name);
+}
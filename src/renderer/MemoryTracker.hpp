@@ -0,0 +1,141 @@
+#pragma once
+
+#include "BufferObject.hpp"
+
+#include <gli/format.hpp>
+#include <gli/target.hpp>
+#include <gli/type.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+enum class MemoryCategory {
+    Buffer,
+    Texture,
+    RenderTarget // Textures which are attached to a render target
+};
+
+struct MemoryUsage {
+    size_t current_bytes;
+    size_t peak_bytes;
+    size_t current_count; // Number of resources which currently have memory allocated
+
+    MemoryUsage() : current_bytes(0), peak_bytes(0), current_count(0) {
+    }
+};
+
+typedef uint64_t MemoryResourceId;
+
+struct MemoryResourceInfo {
+    MemoryResourceId id;
+    MemoryCategory category;
+    size_t size;
+    std::string name;
+
+    // Only valid for buffers
+    BufferType buffer_type;
+    BufferUsage buffer_usage;
+
+    // Only valid for textures and render targets
+    gli::format format;
+    gli::target target;
+    size_t levels;
+
+    MemoryResourceInfo()
+        : id(0), category(MemoryCategory::Buffer), size(0), buffer_type(BufferType::None),
+          buffer_usage(BufferUsage::Static), format(gli::FORMAT_UNDEFINED), target(gli::TARGET_2D), levels(0) {
+    }
+};
+
+// Keeps track of the GPU memory used by the resources of a renderer. The sizes are computed from the requested storage
+// so driver overhead like alignment or padding is not included. Current and peak usage is available in total, per
+// category, per buffer type and usage and per texture format, target and mipmap count. Textures which are attached to a
+// render target are counted in the render target category but are also included in the texture format, target and
+// mipmap statistics.
+//
+// All functions may be called from any thread.
+class MemoryTracker {
+    mutable std::mutex _lock;
+
+    MemoryResourceId _nextId;
+    std::unordered_map<MemoryResourceId, MemoryResourceInfo> _resources;
+
+    MemoryUsage _totalUsage;
+    std::map<MemoryCategory, MemoryUsage> _categoryUsage;
+    std::map<std::pair<BufferType, BufferUsage>, MemoryUsage> _bufferUsage;
+    std::map<gli::format, MemoryUsage> _textureFormatUsage;
+    std::map<gli::target, MemoryUsage> _textureTargetUsage;
+    std::map<size_t, MemoryUsage> _textureLevelUsage;
+
+    void addUsage(const MemoryResourceInfo& info);
+
+    void removeUsage(const MemoryResourceInfo& info);
+
+    MemoryResourceInfo& getResource(MemoryResourceId id);
+ public:
+    MemoryTracker();
+
+    MemoryResourceId registerResource(MemoryCategory category);
+
+    void unregisterResource(MemoryResourceId id);
+
+    // Replaces the previous allocation of the resource. A size of zero means that no memory is allocated.
+    void setBufferAllocation(MemoryResourceId id, BufferType type, BufferUsage usage, size_t size);
+
+    void setTextureAllocation(MemoryResourceId id, gli::format format, gli::target target, size_t levels, size_t size);
+
+    void setCategory(MemoryResourceId id, MemoryCategory category);
+
+    void setName(MemoryResourceId id, const std::string& name);
+
+    MemoryUsage getTotalUsage() const;
+
+    MemoryUsage getCategoryUsage(MemoryCategory category) const;
+
+    MemoryUsage getBufferUsage(BufferType type, BufferUsage usage) const;
+
+    MemoryUsage getTextureFormatUsage(gli::format format) const;
+
+    MemoryUsage getTextureTargetUsage(gli::target target) const;
+
+    MemoryUsage getTextureLevelUsage(size_t levels) const;
+
+    // Returns a copy of all currently registered resources, mostly useful for finding out which resources use the most
+    // memory
+    std::vector<MemoryResourceInfo> getResources() const;
+
+    // Sets all peak values to the current usage
+    void resetPeaks();
+
+    // Computes the storage size of a texture with the given properties, including all faces and mipmap levels
+    static size_t computeTextureSize(gli::format format,
+                                     gli::target target,
+                                     const gli::extent3d& extent,
+                                     size_t levels);
+};
+
+// Registers a resource in a memory tracker for as long as this object lives. Resources of the renderer backends own an
+// instance of this and update it whenever their storage changes.
+class TrackedMemory {
+    MemoryTracker* _tracker;
+    MemoryResourceId _id;
+ public:
+    TrackedMemory(MemoryTracker* tracker, MemoryCategory category);
+    ~TrackedMemory();
+
+    TrackedMemory(const TrackedMemory&) = delete;
+    TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+    void setBufferAllocation(BufferType type, BufferUsage usage, size_t size);
+
+    void setTextureAllocation(gli::format format, gli::target target, size_t levels, size_t size);
+
+    void setCategory(MemoryCategory category);
+
+    void setName(const std::string& name);
+};
@@ -122,6 +122,54 @@ struct PipelineProperties {
     }
 };
 
+inline bool operator==(const PipelineProperties& lhs, const PipelineProperties& rhs) {
+    return lhs.shaderType == rhs.shaderType && lhs.shaderFlags == rhs.shaderFlags
+        && lhs.primitive_type == rhs.primitive_type && lhs.vertexInput == rhs.vertexInput
+        && lhs.depthMode == rhs.depthMode && lhs.depthFunction == rhs.depthFunction
+        && lhs.enableBlending == rhs.enableBlending && lhs.blendFunction == rhs.blendFunction
+        && lhs.enableFaceCulling == rhs.enableFaceCulling && lhs.culledFace == rhs.culledFace
+        && lhs.frontFace == rhs.frontFace && lhs.enableScissor == rhs.enableScissor
+        && lhs.enableStencil == rhs.enableStencil && lhs.stencilMask == rhs.stencilMask
+        && lhs.stencilFunc == rhs.stencilFunc && lhs.frontStencilOp == rhs.frontStencilOp
+        && lhs.backStencilOp == rhs.backStencilOp && lhs.colorMask == rhs.colorMask;
+}
+
+namespace std {
+template<>
+struct hash<PipelineProperties> {
+    size_t operator()(const PipelineProperties& props) const {
+        size_t seed = 0;
+        hash_combine(seed, props.shaderType);
+        hash_combine(seed, props.shaderFlags);
+        hash_combine(seed, props.primitive_type);
+        hash_combine(seed, props.vertexInput);
+        hash_combine(seed, props.depthMode);
+        hash_combine(seed, props.depthFunction);
+        hash_combine(seed, props.enableBlending);
+        hash_combine(seed, props.blendFunction);
+        hash_combine(seed, props.enableFaceCulling);
+        hash_combine(seed, props.culledFace);
+        hash_combine(seed, props.frontFace);
+        hash_combine(seed, props.enableScissor);
+        hash_combine(seed, props.enableStencil);
+        hash_combine(seed, props.stencilMask);
+        hash_combine(seed, std::get<0>(props.stencilFunc));
+        hash_combine(seed, std::get<1>(props.stencilFunc));
+        hash_combine(seed, std::get<2>(props.stencilFunc));
+        hash_combine(seed, std::get<0>(props.frontStencilOp));
+        hash_combine(seed, std::get<1>(props.frontStencilOp));
+        hash_combine(seed, std::get<2>(props.frontStencilOp));
+        hash_combine(seed, std::get<0>(props.backStencilOp));
+        hash_combine(seed, std::get<1>(props.backStencilOp));
+        hash_combine(seed, std::get<2>(props.backStencilOp));
+        for (glm::length_t i = 0; i < 4; ++i) {
+            hash_combine(seed, props.colorMask[i]);
+        }
+        return seed;
+    }
+};
+}
+
 class PipelineState {
  public:
     virtual ~PipelineState() { }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,6 +20,27 @@ struct ProfilingResult {
     uint64_t cpu_time;
 };
 
+// API usage of a single frame. Every counter is the number of calls that were actually issued to the underlying API,
+// calls filtered out by the state cache are only counted in skipped_state_changes.
+struct FrameStatistics {
+    uint64_t draw_calls;
+    uint64_t pipeline_binds;
+    uint64_t descriptor_set_binds;
+    uint64_t buffer_uploads;
+    uint64_t buffer_upload_bytes;
+    uint64_t texture_binds;
+    uint64_t program_switches;
+    uint64_t framebuffer_switches;
+
+    uint64_t state_changes;
+    uint64_t skipped_state_changes;
+
+    FrameStatistics()
+        : draw_calls(0), pipeline_binds(0), descriptor_set_binds(0), buffer_uploads(0), buffer_upload_bytes(0),
+          texture_binds(0), program_switches(0), framebuffer_switches(0), state_changes(0), skipped_state_changes(0) {
+    }
+};
+
 class Profiler {
 public:
     virtual ~Profiler() {}
@@ -26,4 +48,7 @@ public:
     virtual ProfilingCategory* createCategory(const std::string& name) = 0;
 
     virtual std::vector<ProfilingResult> getResults() = 0;
+
+    // Returns the statistics of the last frame that was presented
+    virtual FrameStatistics getFrameStatistics() = 0;
 };
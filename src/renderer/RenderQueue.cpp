@@ -0,0 +1,204 @@
+//
+//
+
+#include "RenderQueue.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const uint32_t PASS_BITS = 4;
+const uint32_t PIPELINE_BITS = 10;
+const uint32_t DESCRIPTOR_SET_BITS = 14;
+const uint32_t VERTEX_ARRAY_BITS = 12;
+const uint32_t DEPTH_BITS = 24;
+
+static_assert(PASS_BITS + PIPELINE_BITS + DESCRIPTOR_SET_BITS + VERTEX_ARRAY_BITS + DEPTH_BITS == 64,
+              "Sort key bits do not add up!");
+
+const uint32_t PASS_SHIFT = 64 - PASS_BITS;
+
+uint64_t mask(uint32_t bits) {
+    return (uint64_t(1) << bits) - 1;
+}
+
+uint32_t getObjectId(std::unordered_map<const void*, uint32_t>& ids, const void* object, uint32_t bits) {
+    if (object == nullptr) {
+        // Id 0 is reserved so that null objects are sorted first
+        return 0;
+    }
+
+    auto iter = ids.find(object);
+    if (iter != ids.end()) {
+        return iter->second;
+    }
+
+    if (ids.size() + 1 > mask(bits)) {
+        // Out of ids. Starting over only affects the sort quality, not the correctness.
+        ids.clear();
+    }
+
+    auto id = static_cast<uint32_t>(ids.size() + 1);
+    ids.insert(std::make_pair(object, id));
+    return id;
+}
+
+uint64_t quantizeDepth(float depth) {
+    if (!(depth > 0.f)) {
+        // Also catches NaN
+        return 0;
+    }
+
+    // The bit pattern of a positive float is ordered the same way as its value so the upper bits give a quantized depth
+    // which has more precision close to the camera
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+
+    return bits >> (32 - DEPTH_BITS);
+}
+}
+
+RenderQueue::RenderQueue(RenderQueueSortMode mode) : _mode(mode), _sorted(true) {
+}
+
+uint64_t RenderQueue::computeKey(uint32_t pass, const RenderQueueItem& item, float depth) {
+    uint64_t pipeline = getObjectId(_pipelineIds, item.pipeline, PIPELINE_BITS);
+    uint64_t descriptorSet = getObjectId(_descriptorSetIds, item.descriptor_set, DESCRIPTOR_SET_BITS);
+    uint64_t vertexArray = getObjectId(_vertexArrayIds, item.vertex_array, VERTEX_ARRAY_BITS);
+    uint64_t quantizedDepth = quantizeDepth(depth);
+
+    uint64_t key = uint64_t(pass) << PASS_SHIFT;
+    switch (_mode) {
+        case RenderQueueSortMode::FrontToBack:
+            key |= pipeline << (DESCRIPTOR_SET_BITS + VERTEX_ARRAY_BITS + DEPTH_BITS);
+            key |= descriptorSet << (VERTEX_ARRAY_BITS + DEPTH_BITS);
+            key |= vertexArray << DEPTH_BITS;
+            key |= quantizedDepth;
+            break;
+        case RenderQueueSortMode::BackToFront:
+            key |= (~quantizedDepth & mask(DEPTH_BITS)) << (PIPELINE_BITS + DESCRIPTOR_SET_BITS + VERTEX_ARRAY_BITS);
+            key |= pipeline << (DESCRIPTOR_SET_BITS + VERTEX_ARRAY_BITS);
+            key |= descriptorSet << VERTEX_ARRAY_BITS;
+            key |= vertexArray;
+            break;
+    }
+
+    return key;
+}
+
+void RenderQueue::add(uint32_t pass, const RenderQueueItem& item, float depth) {
+    Assertion(pass < MAX_PASSES, "Render pass index is out of range!");
+
+    SortEntry entry;
+    entry.key = computeKey(pass, item, depth);
+    entry.item = static_cast<uint32_t>(_items.size());
+
+    _items.push_back(item);
+    _entries.push_back(entry);
+
+    _sorted = false;
+}
+
+void RenderQueue::radixSort() {
+    const size_t NUM_BYTES = sizeof(uint64_t);
+
+    // Compute the histograms of all bytes in one go
+    size_t histograms[NUM_BYTES][256];
+    std::memset(histograms, 0, sizeof(histograms));
+
+    for (auto& entry : _entries) {
+        for (size_t byte = 0; byte < NUM_BYTES; ++byte) {
+            ++histograms[byte][(entry.key >> (byte * 8)) & 0xFF];
+        }
+    }
+
+    _sortBuffer.resize(_entries.size());
+
+    for (size_t byte = 0; byte < NUM_BYTES; ++byte) {
+        auto& histogram = histograms[byte];
+
+        // If all keys have the same value in this byte then this pass would not change anything. This is very common
+        // since the pass and id bits are usually sparsely populated.
+        auto firstValue = (_entries.front().key >> (byte * 8)) & 0xFF;
+        if (histogram[firstValue] == _entries.size()) {
+            continue;
+        }
+
+        size_t offsets[256];
+        size_t sum = 0;
+        for (size_t i = 0; i < 256; ++i) {
+            offsets[i] = sum;
+            sum += histogram[i];
+        }
+
+        for (auto& entry : _entries) {
+            _sortBuffer[offsets[(entry.key >> (byte * 8)) & 0xFF]++] = entry;
+        }
+
+        std::swap(_entries, _sortBuffer);
+    }
+}
+
+void RenderQueue::sort() {
+    if (_sorted) {
+        return;
+    }
+
+    if (!_entries.empty()) {
+        radixSort();
+    }
+
+    _sorted = true;
+}
+
+void RenderQueue::execute(CommandBuffer* cmd, uint32_t pass) {
+    sort();
+
+    auto begin = std::lower_bound(_entries.begin(), _entries.end(), uint64_t(pass) << PASS_SHIFT,
+                                  [](const SortEntry& entry, uint64_t key) { return entry.key < key; });
+
+    PipelineState* currentPipeline = nullptr;
+    DescriptorSet* currentSet = nullptr;
+    VertexArrayObject* currentVertexArray = nullptr;
+
+    for (auto iter = begin; iter != _entries.end() && (iter->key >> PASS_SHIFT) == pass; ++iter) {
+        auto& item = _items[iter->item];
+
+        if (item.pipeline != nullptr && item.pipeline != currentPipeline) {
+            cmd->bindPipeline(item.pipeline);
+            currentPipeline = item.pipeline;
+        }
+        if (item.descriptor_set != currentSet) {
+            if (currentSet != nullptr) {
+                cmd->unbindDescriptorSet(currentSet);
+            }
+            if (item.descriptor_set != nullptr) {
+                cmd->bindDescriptorSet(item.descriptor_set);
+            }
+            currentSet = item.descriptor_set;
+        }
+        if (item.vertex_array != nullptr && item.vertex_array != currentVertexArray) {
+            cmd->bindVertexArrayObject(item.vertex_array);
+            currentVertexArray = item.vertex_array;
+        }
+
+        if (item.indexed) {
+            cmd->drawIndexed(item.count, item.instances, item.offset, item.base_vertex, 0);
+        } else {
+            cmd->draw(item.count, item.instances, item.offset, 0);
+        }
+    }
+
+    if (currentSet != nullptr) {
+        cmd->unbindDescriptorSet(currentSet);
+    }
+}
+
+void RenderQueue::clear() {
+    _items.clear();
+    _entries.clear();
+
+    _sorted = true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CommandBuffer.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+enum class RenderQueueSortMode {
+    FrontToBack, // Sorts by state first and by depth last. Used for opaque geometry.
+    BackToFront // Sorts by depth first which is required for transparent geometry
+};
+
+struct RenderQueueItem {
+    // A null pipeline keeps the pipeline that was bound before the queue is executed. These items are sorted before
+    // all items with a pipeline.
+    PipelineState* pipeline;
+    DescriptorSet* descriptor_set;
+    VertexArrayObject* vertex_array;
+
+    bool indexed;
+    uint32_t count;
+    uint32_t offset;
+    uint32_t base_vertex;
+    uint32_t instances;
+
+    RenderQueueItem()
+        : pipeline(nullptr), descriptor_set(nullptr), vertex_array(nullptr), indexed(false), count(0), offset(0),
+          base_vertex(0), instances(1) {
+    }
+};
+
+// Collects draws with a 64-bit sort key made of the pass, the bound objects and the quantized depth. The queue is
+// radix sorted and replayed through a command buffer while skipping redundant binds.
+class RenderQueue {
+    struct SortEntry {
+        uint64_t key;
+        uint32_t item;
+    };
+
+    RenderQueueSortMode _mode;
+
+    std::vector<RenderQueueItem> _items;
+    std::vector<SortEntry> _entries;
+    std::vector<SortEntry> _sortBuffer;
+
+    bool _sorted;
+
+    // Small ids for the objects used in the sort keys. These stay valid across frames so that the order is stable.
+    std::unordered_map<const void*, uint32_t> _pipelineIds;
+    std::unordered_map<const void*, uint32_t> _descriptorSetIds;
+    std::unordered_map<const void*, uint32_t> _vertexArrayIds;
+
+    uint64_t computeKey(uint32_t pass, const RenderQueueItem& item, float depth);
+
+    void radixSort();
+ public:
+    static const uint32_t MAX_PASSES = 16;
+
+    explicit RenderQueue(RenderQueueSortMode mode);
+
+    // Depth is the view space distance of the draw to the camera
+    void add(uint32_t pass, const RenderQueueItem& item, float depth);
+
+    void sort();
+
+    // Executes all draws of the specified pass. The queue is sorted first if that hasn't been done yet.
+    void execute(CommandBuffer* cmd, uint32_t pass);
+
+    void clear();
+
+    size_t size() const {
+        return _items.size();
+    }
+};
@@ -18,6 +18,8 @@
 #include "CommandBuffer.hpp"
 #include "PipelineState.hpp"
 #include "Debugging.hpp"
+#include "UploadQueue.hpp"
+#include "MemoryTracker.hpp"
 
 enum class SettingsLevel {
     Disabled,
@@ -63,6 +65,23 @@ enum class GraphicsCapability {
 
 struct RendererLimits {
     size_t uniform_offset_alignment;
+
+    // Number of frames the CPU may be ahead of the GPU. Memory which was written in one frame may be written again
+    // after this many frames were presented without waiting for the GPU.
+    size_t frames_in_flight;
+};
+
+// A part of a uniform buffer which can be passed to Descriptor::setUniformBuffer
+struct UniformBufferRange {
+    BufferObject* buffer;
+    size_t offset;
+    size_t size;
+};
+
+// Writable memory for streaming uniforms. The memory is write-only, reading from it may be very slow.
+struct StreamingUniformAllocation {
+    UniformBufferRange range;
+    void* data;
 };
 
 class Renderer {
@@ -79,6 +98,11 @@ class Renderer {
 
     virtual Debugging* getDebugging() = 0;
 
+    // Uploads can be queued from any thread, the queue is processed when the next frame is presented
+    virtual UploadQueue* getUploadQueue() = 0;
+
+    virtual MemoryTracker* getMemoryTracker() = 0;
+
     virtual std::unique_ptr<BufferObject> createBuffer(BufferType type) = 0;
 
     virtual std::unique_ptr<Texture> createTexture() = 0;
@@ -87,11 +111,51 @@ class Renderer {
 
     virtual std::unique_ptr<DescriptorSet> createDescriptorSet(DescriptorSetType type) = 0;
 
-    virtual std::unique_ptr<CommandBuffer> createCommandBuffer() = 0;
+    // Creates a descriptor set in a dense pool owned by the renderer. Use this instead of createDescriptorSet when
+    // there are a lot of sets, e.g. one per mesh. The pool may only be used on the render thread.
+    virtual DescriptorSetHandle createDescriptorSetHandle(DescriptorSetType type) = 0;
+
+    // The returned pointer is only valid until the next call to createDescriptorSetHandle. Stale handles are detected
+    // in debug builds.
+    virtual DescriptorSet* getDescriptorSet(DescriptorSetHandle handle) = 0;
+
+    virtual void destroyDescriptorSet(DescriptorSetHandle handle) = 0;
+
+    // Deferred command buffers may be created and recorded on any thread. Immediate command buffers execute their
+    // commands directly so they may only be used on the render thread.
+    virtual std::unique_ptr<CommandBuffer> createCommandBuffer(
+        CommandBufferMode mode = CommandBufferMode::Immediate) = 0;
+
+    // Returns a command buffer from the pool of the renderer. The same rules as for createCommandBuffer apply. The
+    // buffer must be handed back with releaseCommandBuffer once it is not needed anymore, usually at the end of the
+    // frame.
+    virtual CommandBuffer* acquireCommandBuffer(CommandBufferMode mode = CommandBufferMode::Immediate) = 0;
+
+    // Resets the buffer and returns it to the pool. Deferred buffers must not be released before they were submitted.
+    virtual void releaseCommandBuffer(CommandBuffer* buffer) = 0;
+
+    // Executes the commands of a deferred command buffer. The commands are kept so a buffer may be submitted multiple
+    // times. Immediate command buffers have already been executed so submitting them does nothing.
+    virtual void submit(CommandBuffer* buffer) = 0;
+
+    // Executes the given command buffers in the order of the array. Must be called on the render thread.
+    virtual void submit(CommandBuffer* const* buffers, size_t count) = 0;
 
     virtual std::unique_ptr<VertexArrayObject> createVertexArrayObject(const VertexInputStateProperties& input,
                                                                        const VertexArrayProperties& props) = 0;
 
+    // Copies uniform data into memory that belongs to the current frame. The returned range is aligned to the uniform
+    // offset alignment and stays valid until presentNextFrame is called so it needs to be requested again every frame.
+    // The renderer keeps the memory of the last frames alive while the GPU may still use it so this never has to wait
+    // for the GPU.
+    virtual UniformBufferRange uploadStreamingUniforms(const void* data, size_t size) = 0;
+
+    // Same as uploadStreamingUniforms but the caller writes the data directly into the returned memory. The written
+    // part has to be passed to commitStreamingUniforms before it is used for drawing.
+    virtual StreamingUniformAllocation allocateStreamingUniforms(size_t size) = 0;
+
+    virtual void commitStreamingUniforms(const UniformBufferRange& range) = 0;
+
     virtual bool hasCapability(GraphicsCapability capability) const = 0;
 
     virtual RendererLimits getLimits() const = 0;
@@ -4,6 +4,8 @@
 #include "RenderTarget.hpp"
 #include "BufferObject.hpp"
 
+#include <util/HandlePool.hpp>
+
 #include <glm/glm.hpp>
 
 enum class DescriptorType {
@@ -60,6 +62,8 @@ class DescriptorSet {
     virtual Descriptor* getDescriptor(DescriptorSetPart part) = 0;
 };
 
+typedef Handle<DescriptorSet> DescriptorSetHandle;
+
 struct ViewUniformData {
     glm::mat4 projection_matrix;
     glm::mat4 view_matrix;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
 #include <gli/texture.hpp>
 #include "Enums.hpp"
 
@@ -68,8 +69,18 @@ class Texture: public TextureHandle {
 
     virtual void initialize(const gli::texture& texture, const FilterProperties& filterProperties) = 0;
 
+    // Splits initialize into separate steps so the data can be uploaded over multiple frames. allocateLevels creates
+    // the storage for all levels of the texture without data and uploadLevel then copies one image of the texture
+    // into it.
+    virtual void allocateLevels(const gli::texture& texture, const FilterProperties& filterProperties) = 0;
+
+    virtual void uploadLevel(const gli::texture& texture, size_t layer, size_t face, size_t level) = 0;
+
     virtual void update(const gli::extent3d& position,
                         const gli::extent3d& size, const gli::format dataFormat, const void* data) = 0;
 
     virtual gli::extent3d getSize() const = 0;
+
+    // The name is shown in graphics debuggers and in the memory statistics of the renderer
+    virtual void setDebugName(const std::string& name) = 0;
 };
@@ -0,0 +1,183 @@
+//
+//
+
+#include "UploadQueue.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+UploadQueue::Upload::Upload()
+    : type(UploadType::Buffer), ticket(0), size(0), buffer(nullptr), buffer_offset(0), texture(nullptr), layer(0),
+      face(0), level(0) {
+}
+
+UploadQueue::UploadQueue()
+    : _pendingBytes(0), _processing(false), _nextTicket(1), _completedTicket(0), _frameBudget(DEFAULT_FRAME_BUDGET) {
+}
+
+UploadTicket UploadQueue::enqueue(std::vector<Upload>&& parts) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto ticket = _nextTicket++;
+    for (auto& part : parts) {
+        part.ticket = ticket;
+        _pendingBytes += part.size;
+
+        _pending.push_back(std::move(part));
+    }
+
+    return ticket;
+}
+
+void UploadQueue::updateCompletedTicket() {
+    _completedTicket = _pending.empty() ? _nextTicket - 1 : _pending.front().ticket - 1;
+}
+
+UploadTicket UploadQueue::uploadBuffer(BufferObject* buffer, size_t offset, const void* data, size_t size) {
+    Assertion(buffer != nullptr, "Buffer may not be null!");
+    Assertion(size > 0, "Size may not be zero!");
+
+    auto partSize = std::max(_frameBudget.load(), (size_t) 1);
+    auto bytes = static_cast<const uint8_t*>(data);
+
+    std::vector<Upload> parts;
+    parts.reserve((size + partSize - 1) / partSize);
+    for (size_t partOffset = 0; partOffset < size; partOffset += partSize) {
+        Upload upload;
+        upload.type = UploadType::Buffer;
+        upload.size = std::min(partSize, size - partOffset);
+        upload.buffer = buffer;
+        upload.buffer_offset = offset + partOffset;
+        upload.buffer_data.assign(bytes + partOffset, bytes + partOffset + upload.size);
+
+        parts.push_back(std::move(upload));
+    }
+
+    return enqueue(std::move(parts));
+}
+
+UploadTicket UploadQueue::uploadTexture(Texture* texture,
+                                        const gli::texture& data,
+                                        const FilterProperties& filterProperties) {
+    Assertion(texture != nullptr, "Texture may not be null!");
+
+    // This only keeps the data alive instead of copying it
+    std::shared_ptr<gli::texture> textureData(new gli::texture(data));
+
+    std::vector<Upload> parts;
+    parts.reserve(1 + data.layers() * data.faces() * data.levels());
+
+    // Allocating the storage does not transfer any data so it does not count against the budget
+    Upload storage;
+    storage.type = UploadType::TextureStorage;
+    storage.texture = texture;
+    storage.texture_data = textureData;
+    storage.filter_properties = filterProperties;
+    parts.push_back(std::move(storage));
+
+    for (size_t layer = 0; layer < data.layers(); ++layer) {
+        for (size_t face = 0; face < data.faces(); ++face) {
+            for (size_t level = 0; level < data.levels(); ++level) {
+                Upload upload;
+                upload.type = UploadType::TextureLevel;
+                upload.size = data.size(level);
+                upload.texture = texture;
+                upload.texture_data = textureData;
+                upload.layer = layer;
+                upload.face = face;
+                upload.level = level;
+
+                parts.push_back(std::move(upload));
+            }
+        }
+    }
+
+    return enqueue(std::move(parts));
+}
+
+void UploadQueue::cancel(UploadTicket ticket) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto end = std::remove_if(_pending.begin(), _pending.end(), [this, ticket](const Upload& upload) {
+        if (upload.ticket != ticket) {
+            return false;
+        }
+        _pendingBytes -= upload.size;
+        return true;
+    });
+    _pending.erase(end, _pending.end());
+
+    // process updates the ticket itself once the current part is done
+    if (!_processing) {
+        updateCompletedTicket();
+    }
+}
+
+bool UploadQueue::isComplete(UploadTicket ticket) const {
+    return ticket <= _completedTicket.load();
+}
+
+UploadTicket UploadQueue::getLastTicket() {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return _nextTicket - 1;
+}
+
+size_t UploadQueue::getPendingBytes() {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    return _pendingBytes;
+}
+
+void UploadQueue::setFrameBudget(size_t bytes) {
+    _frameBudget = bytes;
+}
+
+void UploadQueue::process() {
+    size_t uploaded = 0;
+    auto budget = _frameBudget.load();
+
+    while (true) {
+        Upload upload;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+
+            updateCompletedTicket();
+            _processing = false;
+
+            if (_pending.empty()) {
+                return;
+            }
+
+            // Always make progress even if a single part is larger than the budget
+            auto& next = _pending.front();
+            if (uploaded > 0 && uploaded + next.size > budget) {
+                return;
+            }
+
+            upload = std::move(next);
+            _pending.pop_front();
+            _pendingBytes -= upload.size;
+            _processing = true;
+        }
+
+        switch (upload.type) {
+            case UploadType::Buffer:
+                upload.buffer->updateData(upload.buffer_data.data(),
+                                          upload.buffer_offset,
+                                          upload.buffer_data.size(),
+                                          UpdateFlags::None);
+                break;
+            case UploadType::TextureStorage:
+                upload.texture->allocateLevels(*upload.texture_data, upload.filter_properties);
+                break;
+            case UploadType::TextureLevel:
+                upload.texture->uploadLevel(*upload.texture_data, upload.layer, upload.face, upload.level);
+                break;
+        }
+
+        uploaded += upload.size;
+    }
+}
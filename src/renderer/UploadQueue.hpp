@@ -0,0 +1,96 @@
+#pragma once
+
+#include "BufferObject.hpp"
+#include "Texture.hpp"
+
+#include <gli/texture.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Identifies an upload. Tickets are handed out in increasing order and uploads complete in that order.
+typedef uint64_t UploadTicket;
+
+// Collects buffer and texture uploads from any thread and executes them on the render thread at the end of a frame.
+// The data is copied into system memory when the upload is queued so the caller may free its memory right away. At most
+// the frame budget is uploaded per frame so that loading large assets is spread over multiple frames instead of
+// stalling a single one. Textures are uploaded one image of a mipmap level at a time and buffer ranges are split into
+// parts of at most the frame budget so only a single image that is larger than the budget can exceed it.
+//
+// The target objects have to stay alive until their upload is complete or it was cancelled.
+class UploadQueue {
+ public:
+    static const size_t DEFAULT_FRAME_BUDGET = 8 * 1024 * 1024;
+
+ private:
+    enum class UploadType {
+        Buffer,
+        TextureStorage,
+        TextureLevel
+    };
+
+    // A part of an upload. All parts of an upload share its ticket and only the last one completes it.
+    struct Upload {
+        UploadType type;
+        UploadTicket ticket;
+        size_t size;
+
+        BufferObject* buffer;
+        size_t buffer_offset;
+        std::vector<uint8_t> buffer_data;
+
+        Texture* texture;
+        // gli textures share their storage so all parts of a texture upload reference the same data
+        std::shared_ptr<gli::texture> texture_data;
+        FilterProperties filter_properties;
+        size_t layer;
+        size_t face;
+        size_t level;
+
+        Upload();
+    };
+
+    std::mutex _lock;
+    std::deque<Upload> _pending;
+    size_t _pendingBytes;
+    // Set while process executes a part outside of the lock so that cancel does not complete the ticket early
+    bool _processing;
+
+    UploadTicket _nextTicket;
+    std::atomic<UploadTicket> _completedTicket;
+
+    std::atomic<size_t> _frameBudget;
+
+    UploadTicket enqueue(std::vector<Upload>&& parts);
+
+    // Everything before the first pending part is either done or cancelled. Requires the lock.
+    void updateCompletedTicket();
+ public:
+    UploadQueue();
+
+    // Copies the data into the buffer at the specified offset. The storage of the buffer has to be allocated already.
+    UploadTicket uploadBuffer(BufferObject* buffer, size_t offset, const void* data, size_t size);
+
+    // Initializes the texture with all levels of the given texture data
+    UploadTicket uploadTexture(Texture* texture, const gli::texture& data, const FilterProperties& filterProperties);
+
+    // Drops the parts of the upload which have not been executed yet and marks it as complete. The target may be
+    // destroyed afterwards. Must be called on the render thread. Parts which were already executed are not undone.
+    void cancel(UploadTicket ticket);
+
+    bool isComplete(UploadTicket ticket) const;
+
+    // Returns the ticket of the last upload that was queued so far. Once it is complete all uploads are done.
+    UploadTicket getLastTicket();
+
+    size_t getPendingBytes();
+
+    void setFrameBudget(size_t bytes);
+
+    // Executes the queued uploads until the frame budget is used up. Must be called on the render thread.
+    void process();
+};
@@ -4,11 +4,14 @@
 #ifndef PROJECT_VERTEXLAYOUT_HPP
 #define PROJECT_VERTEXLAYOUT_HPP
 
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <vector>
 #include "BufferObject.hpp"
 
+#include <util/HashUtil.hpp>
+
 enum class AttributeType {
     Position,
     TexCoord,
@@ -25,9 +28,51 @@ enum class DataFormat {
     Vec4,
     Vec3,
     Vec2,
-    Float
+    Float,
+
+    // Packed formats, these are converted to floating point vectors when they are read so shaders can use them like the
+    // float formats. Normalized integers are mapped to [0, 1] (UNorm) or [-1, 1] (SNorm).
+    HalfVec2,
+    HalfVec4,
+    UNorm8Vec4,
+    SNorm8Vec4,
+    UNorm16Vec2,
+    UNorm16Vec4,
+    SNorm16Vec2,
+    SNorm16Vec4,
+    SNorm10Vec3W2 // Three 10-bit components and a 2-bit w component packed into 32 bits, x is in the lowest bits
 };
 
+// Returns the size of one attribute value with the specified format in bytes
+inline size_t getDataFormatSize(DataFormat format) {
+    switch (format) {
+        case DataFormat::Vec4:
+            return 4 * sizeof(float);
+        case DataFormat::Vec3:
+            return 3 * sizeof(float);
+        case DataFormat::Vec2:
+            return 2 * sizeof(float);
+        case DataFormat::Float:
+            return sizeof(float);
+        case DataFormat::HalfVec2:
+            return 2 * sizeof(uint16_t);
+        case DataFormat::HalfVec4:
+            return 4 * sizeof(uint16_t);
+        case DataFormat::UNorm8Vec4:
+        case DataFormat::SNorm8Vec4:
+            return 4 * sizeof(uint8_t);
+        case DataFormat::UNorm16Vec2:
+        case DataFormat::SNorm16Vec2:
+            return 2 * sizeof(uint16_t);
+        case DataFormat::UNorm16Vec4:
+        case DataFormat::SNorm16Vec4:
+            return 4 * sizeof(uint16_t);
+        case DataFormat::SNorm10Vec3W2:
+            return sizeof(uint32_t);
+    }
+    return 0;
+}
+
 struct VertexAttributeProperties {
     AttributeType type;
     uint32_t bufferBinding;
@@ -75,6 +120,40 @@ inline void VertexInputStateProperties::addBufferBinding(uint32_t buffer, bool i
     bufferBindings.push_back(props);
 }
 
+inline bool operator==(const VertexAttributeProperties& lhs, const VertexAttributeProperties& rhs) {
+    return lhs.type == rhs.type && lhs.bufferBinding == rhs.bufferBinding && lhs.format == rhs.format
+        && lhs.offset == rhs.offset;
+}
+
+inline bool operator==(const VertexBufferBindingProperties& lhs, const VertexBufferBindingProperties& rhs) {
+    return lhs.bufferBinding == rhs.bufferBinding && lhs.instanced == rhs.instanced && lhs.stride == rhs.stride;
+}
+
+inline bool operator==(const VertexInputStateProperties& lhs, const VertexInputStateProperties& rhs) {
+    return lhs.components == rhs.components && lhs.bufferBindings == rhs.bufferBindings;
+}
+
+namespace std {
+template<>
+struct hash<VertexInputStateProperties> {
+    size_t operator()(const VertexInputStateProperties& props) const {
+        size_t seed = 0;
+        for (auto& component : props.components) {
+            hash_combine(seed, component.type);
+            hash_combine(seed, component.bufferBinding);
+            hash_combine(seed, component.format);
+            hash_combine(seed, component.offset);
+        }
+        for (auto& binding : props.bufferBindings) {
+            hash_combine(seed, binding.bufferBinding);
+            hash_combine(seed, binding.instanced);
+            hash_combine(seed, binding.stride);
+        }
+        return seed;
+    }
+};
+}
+
 class VertexArrayObject {
  public:
     virtual ~VertexArrayObject() {}
@@ -0,0 +1,86 @@
+//
+//
+
+#include "NullBufferObject.hpp"
+#include "NullRenderer.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <cstring>
+
+NullBufferObject::NullBufferObject(NullRenderer* renderer, BufferType type)
+    : NullObject(renderer), _type(type), _mapped(false), _persistent(false),
+      _memory(renderer->getMemoryTracker(), MemoryCategory::Buffer) {
+}
+
+BufferType NullBufferObject::getType() const {
+    return _type;
+}
+
+void NullBufferObject::setData(const void* data, size_t size, BufferUsage usage) {
+    _persistent = usage == BufferUsage::PersistentStreaming;
+
+    _data.resize(size);
+    if (data != nullptr) {
+        std::memcpy(_data.data(), data, size);
+    }
+
+    _memory.setBufferAllocation(_type, usage, size);
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.buffer_uploads;
+    stats.buffer_bytes_uploaded += size;
+}
+
+void NullBufferObject::updateData(const void* data, size_t offset, size_t size, UpdateFlags) {
+    Assertion(offset + size <= _data.size(), "Buffer update is out of range!");
+
+    std::memcpy(_data.data() + offset, data, size);
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.buffer_uploads;
+    stats.buffer_bytes_uploaded += size;
+}
+
+void* NullBufferObject::map(size_t offset, size_t size, BufferMapFlags flags) {
+    Assertion(!_mapped, "Buffer is already mapped!");
+    Assertion(!_persistent, "Persistent buffers can't be mapped, use the persistent pointer instead!");
+    Assertion(offset + size <= _data.size(), "Buffer mapping is out of range!");
+
+    _mapped = true;
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.buffer_maps;
+    if (flags & BufferMapFlags::Write) {
+        // Assume that the whole mapped range is written
+        stats.buffer_bytes_uploaded += size;
+    }
+
+    return _data.data() + offset;
+}
+
+bool NullBufferObject::unmap() {
+    Assertion(_mapped, "Buffer is not mapped!");
+
+    _mapped = false;
+    return true;
+}
+
+void* NullBufferObject::getPersistentPointer() {
+    Assertion(_persistent, "Buffer was not created with persistent streaming usage!");
+
+    return _data.data();
+}
+
+void NullBufferObject::flushPersistentRange(size_t offset, size_t size) {
+    Assertion(_persistent, "Buffer was not created with persistent streaming usage!");
+    Assertion(offset + size <= _data.size(), "Flushed range is out of range!");
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.buffer_uploads;
+    stats.buffer_bytes_uploaded += size;
+}
+
+void NullBufferObject::setDebugName(const std::string& name) {
+    _memory.setName(name);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "renderer/BufferObject.hpp"
+#include "renderer/MemoryTracker.hpp"
+#include "NullObject.hpp"
+
+#include <vector>
+#include <cstdint>
+
+// Keeps the buffer contents in system memory so that mapping works the same way as with a real buffer
+class NullBufferObject final: NullObject, public BufferObject {
+    BufferType _type;
+    std::vector<uint8_t> _data;
+    bool _mapped;
+    bool _persistent;
+
+    TrackedMemory _memory;
+ public:
+    NullBufferObject(NullRenderer* renderer, BufferType type);
+    ~NullBufferObject() {}
+
+    BufferType getType() const override;
+
+    void setData(const void* data, size_t size, BufferUsage usage) override;
+
+    void updateData(const void* data, size_t offset, size_t size, UpdateFlags flags) override;
+
+    void* map(size_t offset, size_t size, BufferMapFlags flags) override;
+
+    bool unmap() override;
+
+    void* getPersistentPointer() override;
+
+    void flushPersistentRange(size_t offset, size_t size) override;
+
+    void setDebugName(const std::string& name) override;
+};
@@ -0,0 +1,189 @@
+//
+//
+
+#include "NullCommandBuffer.hpp"
+#include "NullRenderer.hpp"
+#include "NullVertexArrayObject.hpp"
+
+#include <util/Assertion.hpp>
+
+NullCommandBuffer::NullCommandBuffer(NullRenderer* renderer, CommandBufferMode mode)
+    : NullObject(renderer), _mode(mode) {
+}
+
+CommandBufferMode NullCommandBuffer::getMode() const {
+    return _mode;
+}
+
+void NullCommandBuffer::reset() {
+    _commands.clear();
+}
+
+void NullCommandBuffer::record(CommandType type,
+                               void* object,
+                               uint32_t a0,
+                               uint32_t a1,
+                               uint32_t a2,
+                               uint32_t a3,
+                               uint32_t a4) {
+    Command command;
+    command.type = type;
+    command.object = object;
+    command.args[0] = a0;
+    command.args[1] = a1;
+    command.args[2] = a2;
+    command.args[3] = a3;
+    command.args[4] = a4;
+
+    _commands.push_back(command);
+}
+
+void NullCommandBuffer::clear(const glm::vec4&, ClearTarget target) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::Clear, nullptr, static_cast<uint32_t>(target));
+        return;
+    }
+
+    ++_renderer->getStatistics().clears;
+}
+
+void NullCommandBuffer::bindPipeline(PointerWrapper<PipelineState> pipeline) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::BindPipeline, &pipeline);
+        return;
+    }
+
+    auto& stats = _renderer->getStatistics();
+    auto& bindings = _renderer->getBindings();
+
+    ++stats.pipeline_binds;
+    if (bindings.pipeline != &pipeline) {
+        ++stats.pipeline_changes;
+        bindings.pipeline = &pipeline;
+    }
+}
+
+void NullCommandBuffer::bindVertexArrayObject(PointerWrapper<VertexArrayObject> vao) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::BindVertexArrayObject, &vao);
+        return;
+    }
+
+    auto& stats = _renderer->getStatistics();
+    auto& bindings = _renderer->getBindings();
+
+    ++stats.vertex_array_binds;
+    if (bindings.vertex_array != &vao) {
+        ++stats.vertex_array_changes;
+        bindings.vertex_array = &vao;
+    }
+}
+
+void NullCommandBuffer::bindDescriptorSet(PointerWrapper<DescriptorSet> set) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::BindDescriptorSet, &set);
+        return;
+    }
+
+    auto& stats = _renderer->getStatistics();
+    auto& bindings = _renderer->getBindings();
+
+    ++stats.descriptor_set_binds;
+    if (bindings.descriptor_set != &set) {
+        ++stats.descriptor_set_changes;
+        bindings.descriptor_set = &set;
+    }
+}
+
+void NullCommandBuffer::unbindDescriptorSet(PointerWrapper<DescriptorSet> set) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::UnbindDescriptorSet, &set);
+        return;
+    }
+
+    // Unbinding does not change which set is considered bound. Binding the same set again is still redundant.
+}
+
+void NullCommandBuffer::pushConstants(void*, size_t size) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::PushConstants, nullptr, static_cast<uint32_t>(size));
+        return;
+    }
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.push_constant_updates;
+    stats.push_constant_bytes += size;
+}
+
+void NullCommandBuffer::draw(uint32_t vertexCount,
+                             uint32_t instanceCount,
+                             uint32_t vertexOffset,
+                             uint32_t baseInstance) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::Draw, nullptr, vertexCount, instanceCount, vertexOffset, baseInstance);
+        return;
+    }
+
+    Assertion(_renderer->getBindings().vertex_array, "A Vertex Array Object has to be set for drawing!");
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.draw_calls;
+    stats.vertices += vertexCount;
+    stats.instances += instanceCount;
+}
+
+void NullCommandBuffer::drawIndexed(uint32_t indexCount,
+                                    uint32_t instanceCount,
+                                    uint32_t indexOffset,
+                                    uint32_t baseVertex,
+                                    uint32_t baseInstance) {
+    if (_mode == CommandBufferMode::Deferred) {
+        record(CommandType::DrawIndexed, nullptr, indexCount, instanceCount, indexOffset, baseVertex, baseInstance);
+        return;
+    }
+
+    auto vao = static_cast<NullVertexArrayObject*>(_renderer->getBindings().vertex_array);
+    Assertion(vao, "A Vertex Array Object has to be set for drawing!");
+    Assertion(vao->hasIndices(), "Vertex Array Object needs index information for indexed rendering!");
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.draw_calls;
+    ++stats.indexed_draw_calls;
+    stats.vertices += indexCount;
+    stats.instances += instanceCount;
+}
+
+void NullCommandBuffer::execute(NullCommandBuffer* target) const {
+    for (auto& command : _commands) {
+        switch (command.type) {
+            case CommandType::Clear:
+                target->clear(glm::vec4(0.f), static_cast<ClearTarget>(command.args[0]));
+                break;
+            case CommandType::BindPipeline:
+                target->bindPipeline(static_cast<PipelineState*>(command.object));
+                break;
+            case CommandType::BindVertexArrayObject:
+                target->bindVertexArrayObject(static_cast<VertexArrayObject*>(command.object));
+                break;
+            case CommandType::BindDescriptorSet:
+                target->bindDescriptorSet(static_cast<DescriptorSet*>(command.object));
+                break;
+            case CommandType::UnbindDescriptorSet:
+                target->unbindDescriptorSet(static_cast<DescriptorSet*>(command.object));
+                break;
+            case CommandType::PushConstants:
+                target->pushConstants(nullptr, command.args[0]);
+                break;
+            case CommandType::Draw:
+                target->draw(command.args[0], command.args[1], command.args[2], command.args[3]);
+                break;
+            case CommandType::DrawIndexed:
+                target->drawIndexed(command.args[0],
+                                    command.args[1],
+                                    command.args[2],
+                                    command.args[3],
+                                    command.args[4]);
+                break;
+        }
+    }
+}
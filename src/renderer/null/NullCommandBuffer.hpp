@@ -0,0 +1,63 @@
+#pragma once
+
+#include "renderer/CommandBuffer.hpp"
+#include "NullObject.hpp"
+
+#include <vector>
+#include <cstdint>
+
+class NullCommandBuffer final: public CommandBuffer, NullObject {
+    enum class CommandType {
+        Clear,
+        BindPipeline,
+        BindVertexArrayObject,
+        BindDescriptorSet,
+        UnbindDescriptorSet,
+        PushConstants,
+        Draw,
+        DrawIndexed
+    };
+
+    // Deferred commands only keep what is needed for counting. Push constant data is not copied, only its size.
+    struct Command {
+        CommandType type;
+        void* object;
+        uint32_t args[5];
+    };
+
+    CommandBufferMode _mode;
+    std::vector<Command> _commands;
+
+    void record(CommandType type, void* object, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0, uint32_t a3 = 0,
+                uint32_t a4 = 0);
+ public:
+    NullCommandBuffer(NullRenderer* renderer, CommandBufferMode mode);
+    ~NullCommandBuffer() {}
+
+    CommandBufferMode getMode() const override;
+
+    void reset() override;
+
+    void clear(const glm::vec4& color, ClearTarget target) override;
+
+    void bindPipeline(PointerWrapper<PipelineState> pipeline) override;
+
+    void bindVertexArrayObject(PointerWrapper<VertexArrayObject> vao) override;
+
+    void bindDescriptorSet(PointerWrapper<DescriptorSet> set) override;
+
+    void unbindDescriptorSet(PointerWrapper<DescriptorSet> set) override;
+
+    void pushConstants(void* data, size_t size) override;
+
+    void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexOffset, uint32_t baseInstance) override;
+
+    void drawIndexed(uint32_t indexCount,
+                     uint32_t instanceCount,
+                     uint32_t indexOffset,
+                     uint32_t baseVertex,
+                     uint32_t baseInstance) override;
+
+    // Replays the recorded commands of a deferred buffer on an immediate buffer
+    void execute(NullCommandBuffer* target) const;
+};
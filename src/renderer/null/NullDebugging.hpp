@@ -0,0 +1,13 @@
+#pragma once
+
+#include <renderer/Debugging.hpp>
+
+class NullDebugging final: public Debugging {
+ public:
+    ~NullDebugging() {}
+
+    void addMessage(DebugSeverity, const std::string&) override {}
+
+    void pushGroup(const std::string&) override {}
+    void popGroup() override {}
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+class NullRenderer;
+
+class NullObject {
+ protected:
+    NullRenderer* _renderer;
+
+    explicit NullObject(NullRenderer* renderer) : _renderer(renderer) {}
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "renderer/PipelineState.hpp"
+
+class NullPipelineState final: public PipelineState {
+    PrimitiveType _primitiveType;
+ public:
+    explicit NullPipelineState(const PipelineProperties& props) : _primitiveType(props.primitive_type) {}
+    ~NullPipelineState() {}
+
+    PrimitiveType getPrimitiveType() const {
+        return _primitiveType;
+    }
+};
@@ -0,0 +1,66 @@
+//
+//
+
+#include "NullProfiler.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <SDL_timer.h>
+
+NullProfilingCategory::NullProfilingCategory(const std::string& name)
+    : _name(name), _cpuBeginTime(0), _lastCpuTime(0), _hasTime(false) {
+}
+
+void NullProfilingCategory::begin() {
+    Assertion(_cpuBeginTime == 0, "begin() was called without a matching call to end()!");
+
+    _cpuBeginTime = SDL_GetPerformanceCounter();
+}
+
+void NullProfilingCategory::end() {
+    Assertion(_cpuBeginTime != 0, "begin() was not called!");
+
+    _lastCpuTime = SDL_GetPerformanceCounter() - _cpuBeginTime;
+    _hasTime = true;
+
+    _cpuBeginTime = 0;
+}
+
+uint64_t NullProfilingCategory::getTime() {
+    _hasTime = false;
+    return _lastCpuTime;
+}
+
+NullProfiler::NullProfiler() {
+    _cpuTimeFrequency = SDL_GetPerformanceFrequency();
+}
+
+ProfilingCategory* NullProfiler::createCategory(const std::string& name) {
+    _categories.emplace_back(new NullProfilingCategory(name));
+    return _categories.back().get();
+}
+
+std::vector<ProfilingResult> NullProfiler::getResults() {
+    std::vector<ProfilingResult> results;
+
+    for (auto& category : _categories) {
+        if (category->hasTime()) {
+            ProfilingResult result;
+            result.name = category->getName().c_str();
+            result.gpu_time = 0;
+            result.cpu_time = (category->getTime() * 1000000000) / _cpuTimeFrequency;
+
+            results.push_back(result);
+        }
+    }
+
+    return results;
+}
+
+FrameStatistics NullProfiler::getFrameStatistics() {
+    return _lastFrameStatistics;
+}
+
+void NullProfiler::frameFinished(const FrameStatistics& statistics) {
+    _lastFrameStatistics = statistics;
+}
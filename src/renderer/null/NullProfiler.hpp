@@ -0,0 +1,51 @@
+#pragma once
+
+#include <renderer/Profiler.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Only measures CPU times since there is no GPU work. The reported GPU time is always zero.
+class NullProfilingCategory final: public ProfilingCategory {
+    std::string _name;
+
+    uint64_t _cpuBeginTime;
+    uint64_t _lastCpuTime;
+    bool _hasTime;
+ public:
+    explicit NullProfilingCategory(const std::string& name);
+    ~NullProfilingCategory() {}
+
+    const std::string& getName() const {
+        return _name;
+    }
+
+    void begin() override;
+
+    void end() override;
+
+    bool hasTime() const {
+        return _hasTime;
+    }
+
+    uint64_t getTime();
+};
+
+class NullProfiler final: public Profiler {
+    std::vector<std::unique_ptr<NullProfilingCategory>> _categories;
+
+    uint64_t _cpuTimeFrequency;
+
+    FrameStatistics _lastFrameStatistics;
+ public:
+    NullProfiler();
+    ~NullProfiler() {}
+
+    ProfilingCategory* createCategory(const std::string& name) override;
+
+    std::vector<ProfilingResult> getResults() override;
+
+    FrameStatistics getFrameStatistics() override;
+
+    void frameFinished(const FrameStatistics& statistics);
+};
@@ -0,0 +1,86 @@
+//
+//
+
+#include "NullRenderTargetManager.hpp"
+#include "NullRenderer.hpp"
+#include "NullTexture.hpp"
+
+#include <util/Assertion.hpp>
+
+NullRenderTarget::NullRenderTarget(size_t width, size_t height) : _width(width), _height(height) {
+}
+
+NullRenderTarget::NullRenderTarget(RenderTargetProperties&& properties)
+    : _width(properties.width), _height(properties.height), _colorTextures(std::move(properties.color_buffers)),
+      _depthTexture(std::move(properties.depth_texture)) {
+    for (auto& texture : _colorTextures) {
+        static_cast<NullTexture*>(texture.get())->markAsRenderTarget();
+    }
+    if (_depthTexture) {
+        static_cast<NullTexture*>(_depthTexture.get())->markAsRenderTarget();
+    }
+}
+
+void NullRenderTarget::setSize(size_t width, size_t height) {
+    _width = width;
+    _height = height;
+}
+
+size_t NullRenderTarget::getWidth() const {
+    return _width;
+}
+
+size_t NullRenderTarget::getHeight() const {
+    return _height;
+}
+
+void NullRenderTarget::copyToTexture(PointerWrapper<Texture>) {
+}
+
+std::vector<TextureHandle*> NullRenderTarget::getColorTextures() {
+    std::vector<TextureHandle*> handles;
+    for (auto& texture : _colorTextures) {
+        handles.push_back(texture.get());
+    }
+    return handles;
+}
+
+TextureHandle* NullRenderTarget::getDepthTexture() {
+    return _depthTexture.get();
+}
+
+NullRenderTargetManager::NullRenderTargetManager(NullRenderer* renderer)
+    : NullObject(renderer), _defaultRenderTarget(0, 0), _currentRenderTarget(&_defaultRenderTarget) {
+}
+
+void NullRenderTargetManager::updateDefaultTarget(uint32_t width, uint32_t height) {
+    _defaultRenderTarget.setSize(width, height);
+}
+
+std::unique_ptr<RenderTarget> NullRenderTargetManager::createRenderTarget(RenderTargetProperties&& properties) {
+    return std::unique_ptr<RenderTarget>(new NullRenderTarget(std::move(properties)));
+}
+
+void NullRenderTargetManager::useRenderTarget(PointerWrapper<RenderTarget> target) {
+    RenderTarget* newTarget = &target == nullptr ? &_defaultRenderTarget : &target;
+
+    if (newTarget != _currentRenderTarget) {
+        ++_renderer->getStatistics().render_target_changes;
+        _currentRenderTarget = newTarget;
+    }
+}
+
+RenderTarget* NullRenderTargetManager::getCurrentRenderTarget() {
+    return _currentRenderTarget;
+}
+
+void NullRenderTargetManager::pushRenderTargetBinding() {
+    _renderTargetStack.push(_currentRenderTarget);
+}
+
+void NullRenderTargetManager::popRenderTargetBinding() {
+    Assertion(!_renderTargetStack.empty(), "Render target stack is empty!");
+
+    useRenderTarget(_renderTargetStack.top());
+    _renderTargetStack.pop();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "renderer/RenderTargetManager.hpp"
+#include "NullObject.hpp"
+
+#include <stack>
+
+class NullRenderTarget final: public RenderTarget {
+    size_t _width;
+    size_t _height;
+
+    std::vector<std::unique_ptr<Texture>> _colorTextures;
+    std::unique_ptr<Texture> _depthTexture;
+ public:
+    NullRenderTarget(size_t width, size_t height);
+    explicit NullRenderTarget(RenderTargetProperties&& properties);
+    ~NullRenderTarget() {}
+
+    void setSize(size_t width, size_t height);
+
+    size_t getWidth() const override;
+
+    size_t getHeight() const override;
+
+    void copyToTexture(PointerWrapper<Texture> target) override;
+
+    std::vector<TextureHandle*> getColorTextures() override;
+
+    TextureHandle* getDepthTexture() override;
+};
+
+class NullRenderTargetManager final: NullObject, public RenderTargetManager {
+    NullRenderTarget _defaultRenderTarget;
+    RenderTarget* _currentRenderTarget;
+
+    std::stack<RenderTarget*> _renderTargetStack;
+ public:
+    explicit NullRenderTargetManager(NullRenderer* renderer);
+    ~NullRenderTargetManager() {}
+
+    void updateDefaultTarget(uint32_t width, uint32_t height);
+
+    std::unique_ptr<RenderTarget> createRenderTarget(RenderTargetProperties&& properties) override;
+
+    void useRenderTarget(PointerWrapper<RenderTarget> target) override;
+
+    RenderTarget* getCurrentRenderTarget() override;
+
+    void pushRenderTargetBinding() override;
+
+    void popRenderTargetBinding() override;
+};
@@ -0,0 +1,311 @@
+//
+//
+
+#include "NullRenderer.hpp"
+#include "NullBufferObject.hpp"
+#include "NullCommandBuffer.hpp"
+#include "NullTexture.hpp"
+#include "NullShaderParameters.hpp"
+#include "NullPipelineState.hpp"
+#include "NullVertexArrayObject.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+NullRenderer::NullRenderer() : _settingsManager(this), _streamingUniformSize(0), _streamingUniformOffset(0) {
+}
+
+NullRenderer::~NullRenderer() {
+}
+
+void NullRenderer::initialize(SDL_Window*) {
+    _renderTargetManager.reset(new NullRenderTargetManager(this));
+    _profiler.reset(new NullProfiler());
+    _debugging.reset(new NullDebugging());
+    _commandBufferPool.reset(new CommandBufferPool(this));
+    _uploadQueue.reset(new UploadQueue());
+
+    auto settings = _settingsManager.getCurrentSettings();
+    _renderTargetManager->updateDefaultTarget(settings.resolution.x, settings.resolution.y);
+}
+
+void NullRenderer::deinitialize() {
+    _commandBufferPool.reset();
+    _uploadQueue.reset();
+    _streamingUniformBuffer.reset();
+    _retiredStreamingUniformBuffers.clear();
+    _streamingUniformSize = 0;
+    _streamingUniformOffset = 0;
+    _descriptorSetPool.clear();
+    _debugging.reset();
+    _profiler.reset();
+    _renderTargetManager.reset();
+}
+
+RendererSettingsManager* NullRenderer::getSettingsManager() {
+    return &_settingsManager;
+}
+
+RenderTargetManager* NullRenderer::getRenderTargetManager() {
+    return _renderTargetManager.get();
+}
+
+Profiler* NullRenderer::getProfiler() {
+    return _profiler.get();
+}
+
+UploadQueue* NullRenderer::getUploadQueue() {
+    return _uploadQueue.get();
+}
+
+MemoryTracker* NullRenderer::getMemoryTracker() {
+    return &_memoryTracker;
+}
+
+Debugging* NullRenderer::getDebugging() {
+    return _debugging.get();
+}
+
+std::unique_ptr<BufferObject> NullRenderer::createBuffer(BufferType type) {
+    if (type == BufferType::None) {
+        return nullptr;
+    }
+
+    ++_statistics.buffers_created;
+    return std::unique_ptr<BufferObject>(new NullBufferObject(this, type));
+}
+
+std::unique_ptr<CommandBuffer> NullRenderer::createCommandBuffer(CommandBufferMode mode) {
+    // This may be called from any thread so the statistics must not be touched here
+    return std::unique_ptr<CommandBuffer>(new NullCommandBuffer(this, mode));
+}
+
+CommandBuffer* NullRenderer::acquireCommandBuffer(CommandBufferMode mode) {
+    return _commandBufferPool->acquire(mode);
+}
+
+void NullRenderer::releaseCommandBuffer(CommandBuffer* buffer) {
+    _commandBufferPool->release(buffer);
+}
+
+void NullRenderer::submit(CommandBuffer* buffer) {
+    submit(&buffer, 1);
+}
+
+void NullRenderer::submit(CommandBuffer* const* buffers, size_t count) {
+    NullCommandBuffer executor(this, CommandBufferMode::Immediate);
+    for (size_t i = 0; i < count; ++i) {
+        ++_statistics.submits;
+
+        if (buffers[i]->getMode() != CommandBufferMode::Deferred) {
+            // Immediate buffers have already been executed
+            continue;
+        }
+
+        static_cast<NullCommandBuffer*>(buffers[i])->execute(&executor);
+    }
+}
+
+std::unique_ptr<Texture> NullRenderer::createTexture() {
+    ++_statistics.textures_created;
+    return std::unique_ptr<Texture>(new NullTexture(this));
+}
+
+std::unique_ptr<PipelineState> NullRenderer::createPipelineState(const PipelineProperties& props) {
+    ++_statistics.pipelines_created;
+    return std::unique_ptr<PipelineState>(new NullPipelineState(props));
+}
+
+std::unique_ptr<DescriptorSet> NullRenderer::createDescriptorSet(DescriptorSetType type) {
+    ++_statistics.descriptor_sets_created;
+    return std::unique_ptr<DescriptorSet>(new NullDescriptorSet(this, type));
+}
+
+DescriptorSetHandle NullRenderer::createDescriptorSetHandle(DescriptorSetType type) {
+    ++_statistics.descriptor_sets_created;
+    return _descriptorSetPool.create(new NullDescriptorSet(this, type));
+}
+
+DescriptorSet* NullRenderer::getDescriptorSet(DescriptorSetHandle handle) {
+    return _descriptorSetPool.get(handle)->get();
+}
+
+void NullRenderer::destroyDescriptorSet(DescriptorSetHandle handle) {
+    _descriptorSetPool.destroy(handle);
+}
+
+std::unique_ptr<VertexArrayObject> NullRenderer::createVertexArrayObject(const VertexInputStateProperties&,
+                                                                         const VertexArrayProperties& props) {
+    ++_statistics.vertex_arrays_created;
+    return std::unique_ptr<VertexArrayObject>(new NullVertexArrayObject(props));
+}
+
+UniformBufferRange NullRenderer::uploadStreamingUniforms(const void* data, size_t size) {
+    auto allocation = allocateStreamingUniforms(size);
+
+    std::memcpy(allocation.data, data, size);
+    commitStreamingUniforms(allocation.range);
+
+    return allocation.range;
+}
+
+StreamingUniformAllocation NullRenderer::allocateStreamingUniforms(size_t size) {
+    auto alignment = getLimits().uniform_offset_alignment;
+    auto alignedSize = (size + alignment - 1) / alignment * alignment;
+
+    if (_streamingUniformOffset + alignedSize > _streamingUniformSize) {
+        _streamingUniformSize = std::max(_streamingUniformSize * 2, _streamingUniformOffset + alignedSize);
+
+        if (_streamingUniformBuffer) {
+            _retiredStreamingUniformBuffers.push_back(std::move(_streamingUniformBuffer));
+        }
+        _streamingUniformBuffer = createBuffer(BufferType::Uniform);
+        _streamingUniformBuffer->setData(nullptr, _streamingUniformSize, BufferUsage::PersistentStreaming);
+    }
+
+    StreamingUniformAllocation allocation;
+    allocation.range.buffer = _streamingUniformBuffer.get();
+    allocation.range.offset = _streamingUniformOffset;
+    allocation.range.size = size;
+    allocation.data = static_cast<uint8_t*>(_streamingUniformBuffer->getPersistentPointer()) + allocation.range.offset;
+
+    _streamingUniformOffset += alignedSize;
+
+    return allocation;
+}
+
+void NullRenderer::commitStreamingUniforms(const UniformBufferRange& range) {
+    range.buffer->flushPersistentRange(range.offset, range.size);
+}
+
+bool NullRenderer::hasCapability(GraphicsCapability) const {
+    // Pretend to support everything so that all code paths are exercised
+    return true;
+}
+
+RendererLimits NullRenderer::getLimits() const {
+    RendererLimits limits;
+    // The largest alignment that is commonly found on real hardware
+    limits.uniform_offset_alignment = 256;
+    // Nothing reads the buffers so they can be overwritten right away
+    limits.frames_in_flight = 1;
+
+    return limits;
+}
+
+void NullRenderer::presentNextFrame() {
+    _uploadQueue->process();
+
+    ++_statistics.frames;
+
+    auto& start = _frameStartStatistics;
+    auto redundantBinds = (_statistics.pipeline_binds - start.pipeline_binds)
+        - (_statistics.pipeline_changes - start.pipeline_changes)
+        + (_statistics.vertex_array_binds - start.vertex_array_binds)
+        - (_statistics.vertex_array_changes - start.vertex_array_changes)
+        + (_statistics.descriptor_set_binds - start.descriptor_set_binds)
+        - (_statistics.descriptor_set_changes - start.descriptor_set_changes);
+
+    // There is no state cache so the redundant binds are reported as the calls a cache would have skipped
+    FrameStatistics frame;
+    frame.draw_calls = _statistics.draw_calls - start.draw_calls;
+    frame.pipeline_binds = _statistics.pipeline_binds - start.pipeline_binds;
+    frame.descriptor_set_binds = _statistics.descriptor_set_binds - start.descriptor_set_binds;
+    frame.buffer_uploads = _statistics.buffer_uploads - start.buffer_uploads;
+    frame.buffer_upload_bytes = _statistics.buffer_bytes_uploaded - start.buffer_bytes_uploaded;
+    frame.program_switches = _statistics.pipeline_changes - start.pipeline_changes;
+    frame.framebuffer_switches = _statistics.render_target_changes - start.render_target_changes;
+    frame.state_changes = (_statistics.pipeline_changes - start.pipeline_changes)
+        + (_statistics.vertex_array_changes - start.vertex_array_changes)
+        + (_statistics.descriptor_set_changes - start.descriptor_set_changes);
+    frame.skipped_state_changes = redundantBinds;
+
+    _profiler->frameFinished(frame);
+    _frameStartStatistics = _statistics;
+
+    _streamingUniformOffset = 0;
+    _retiredStreamingUniformBuffers.clear();
+
+    // A new frame starts without any bound state
+    _bindings = NullBindings();
+}
+
+NullRendererStatistics& NullRenderer::getStatistics() {
+    return _statistics;
+}
+
+NullBindings& NullRenderer::getBindings() {
+    return _bindings;
+}
+
+void NullRenderer::resetStatistics() {
+    _statistics = NullRendererStatistics();
+    _frameStartStatistics = NullRendererStatistics();
+}
+
+void NullRenderer::printStatistics() const {
+    auto frames = _statistics.frames > 0 ? _statistics.frames : 1;
+
+    printf("Frames: %llu\n", (unsigned long long) _statistics.frames);
+    printf("%-24s %12s %12s\n", "Counter", "Total", "Per frame");
+
+    auto print = [frames](const char* name, uint64_t value) {
+        printf("%-24s %12llu %12.1f\n", name, (unsigned long long) value, (double) value / frames);
+    };
+
+    print("Submits", _statistics.submits);
+    print("Clears", _statistics.clears);
+    print("Draw calls", _statistics.draw_calls);
+    print("Indexed draw calls", _statistics.indexed_draw_calls);
+    print("Vertices", _statistics.vertices);
+    print("Instances", _statistics.instances);
+    print("Pipeline binds", _statistics.pipeline_binds);
+    print("Pipeline changes", _statistics.pipeline_changes);
+    print("VAO binds", _statistics.vertex_array_binds);
+    print("VAO changes", _statistics.vertex_array_changes);
+    print("Descriptor set binds", _statistics.descriptor_set_binds);
+    print("Descriptor set changes", _statistics.descriptor_set_changes);
+    print("Render target changes", _statistics.render_target_changes);
+    print("Push constant updates", _statistics.push_constant_updates);
+    print("Push constant bytes", _statistics.push_constant_bytes);
+    print("Buffer uploads", _statistics.buffer_uploads);
+    print("Buffer bytes uploaded", _statistics.buffer_bytes_uploaded);
+    print("Buffer maps", _statistics.buffer_maps);
+    print("Texture uploads", _statistics.texture_uploads);
+    print("Texture bytes uploaded", _statistics.texture_bytes_uploaded);
+    print("Buffers created", _statistics.buffers_created);
+    print("Textures created", _statistics.textures_created);
+    print("Descriptor sets created", _statistics.descriptor_sets_created);
+    print("Pipelines created", _statistics.pipelines_created);
+    print("VAOs created", _statistics.vertex_arrays_created);
+}
+
+NullRenderer::NullRenderSettingsManager::NullRenderSettingsManager(NullRenderer* renderer) : NullObject(renderer) {
+    _currentSettings.resolution = glm::uvec2(1680, 1050);
+    _currentSettings.vertical_sync = false;
+    _currentSettings.msaa_samples = 0;
+}
+
+void NullRenderer::NullRenderSettingsManager::changeSettings(const RendererSettings& settings) {
+    _currentSettings = settings;
+
+    if (_renderer->_renderTargetManager) {
+        _renderer->_renderTargetManager->updateDefaultTarget(settings.resolution.x, settings.resolution.y);
+    }
+}
+
+bool NullRenderer::NullRenderSettingsManager::supportsSetting(SettingsParameter parameter) const {
+    switch (parameter) {
+        case SettingsParameter::Resolution:
+            return true;
+        case SettingsParameter::VerticalSync:
+            return true;
+        default:
+            return false;
+    }
+}
+
+RendererSettings NullRenderer::NullRenderSettingsManager::getCurrentSettings() const {
+    return _currentSettings;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "renderer/Renderer.hpp"
+#include "NullObject.hpp"
+#include "NullStatistics.hpp"
+#include "NullRenderTargetManager.hpp"
+#include "NullProfiler.hpp"
+#include "NullDebugging.hpp"
+#include "NullShaderParameters.hpp"
+
+#include <renderer/CommandBufferPool.hpp>
+#include <renderer/UploadQueue.hpp>
+
+// Objects that are currently bound by an immediate command buffer. Used for detecting redundant binds.
+struct NullBindings {
+    PipelineState* pipeline;
+    VertexArrayObject* vertex_array;
+    DescriptorSet* descriptor_set;
+
+    NullBindings() : pipeline(nullptr), vertex_array(nullptr), descriptor_set(nullptr) {}
+};
+
+// A renderer which does no GPU work at all and does not need a window. It counts the commands and uploads it receives
+// so that the CPU side of the frame can be benchmarked and tested on machines without a GPU.
+class NullRenderer final: public Renderer {
+ public:
+    class NullRenderSettingsManager: NullObject, public RendererSettingsManager {
+        RendererSettings _currentSettings;
+     public:
+        explicit NullRenderSettingsManager(NullRenderer* renderer);
+
+        virtual ~NullRenderSettingsManager() { }
+
+        virtual void changeSettings(const RendererSettings& settings) override;
+
+        virtual bool supportsSetting(SettingsParameter parameter) const override;
+
+        virtual RendererSettings getCurrentSettings() const override;
+    };
+
+ private:
+    // Declared first so that it outlives all resources which are registered in it
+    MemoryTracker _memoryTracker;
+
+    NullRenderSettingsManager _settingsManager;
+
+    std::unique_ptr<NullRenderTargetManager> _renderTargetManager;
+    std::unique_ptr<NullProfiler> _profiler;
+    std::unique_ptr<NullDebugging> _debugging;
+    std::unique_ptr<CommandBufferPool> _commandBufferPool;
+    std::unique_ptr<UploadQueue> _uploadQueue;
+
+    // Streaming uniforms are never read so a single buffer which is reused every frame is enough. Pointers into a
+    // buffer which had to be replaced by a larger one may still be written until the end of the frame.
+    std::unique_ptr<BufferObject> _streamingUniformBuffer;
+    std::vector<std::unique_ptr<BufferObject>> _retiredStreamingUniformBuffers;
+    size_t _streamingUniformSize;
+    size_t _streamingUniformOffset;
+
+    // The null renderer does not care about the memory layout so the sets are allocated separately
+    HandlePool<std::unique_ptr<NullDescriptorSet>, DescriptorSet> _descriptorSetPool;
+
+    NullRendererStatistics _statistics;
+    NullRendererStatistics _frameStartStatistics; // Used for computing the statistics of a single frame
+    NullBindings _bindings;
+ public:
+    NullRenderer();
+
+    virtual ~NullRenderer();
+
+    // The window is not used and may be null
+    virtual void initialize(SDL_Window* window) override;
+
+    virtual void deinitialize() override;
+
+    virtual RendererSettingsManager* getSettingsManager() override;
+
+    virtual RenderTargetManager* getRenderTargetManager() override;
+
+    virtual Profiler* getProfiler() override;
+
+    virtual Debugging* getDebugging() override;
+
+    virtual UploadQueue* getUploadQueue() override;
+
+    virtual MemoryTracker* getMemoryTracker() override;
+
+    virtual std::unique_ptr<BufferObject> createBuffer(BufferType type) override;
+
+    virtual std::unique_ptr<CommandBuffer> createCommandBuffer(
+        CommandBufferMode mode = CommandBufferMode::Immediate) override;
+
+    virtual CommandBuffer* acquireCommandBuffer(CommandBufferMode mode = CommandBufferMode::Immediate) override;
+
+    virtual void releaseCommandBuffer(CommandBuffer* buffer) override;
+
+    virtual void submit(CommandBuffer* buffer) override;
+
+    virtual void submit(CommandBuffer* const* buffers, size_t count) override;
+
+    virtual std::unique_ptr<Texture> createTexture() override;
+
+    virtual std::unique_ptr<PipelineState> createPipelineState(const PipelineProperties& props) override;
+
+    virtual std::unique_ptr<DescriptorSet> createDescriptorSet(DescriptorSetType type) override;
+
+    virtual DescriptorSetHandle createDescriptorSetHandle(DescriptorSetType type) override;
+
+    virtual DescriptorSet* getDescriptorSet(DescriptorSetHandle handle) override;
+
+    virtual void destroyDescriptorSet(DescriptorSetHandle handle) override;
+
+    virtual std::unique_ptr<VertexArrayObject> createVertexArrayObject(const VertexInputStateProperties& input,
+                                                                       const VertexArrayProperties& props) override;
+
+    virtual UniformBufferRange uploadStreamingUniforms(const void* data, size_t size) override;
+
+    virtual StreamingUniformAllocation allocateStreamingUniforms(size_t size) override;
+
+    virtual void commitStreamingUniforms(const UniformBufferRange& range) override;
+
+    virtual bool hasCapability(GraphicsCapability capability) const override;
+
+    virtual RendererLimits getLimits() const override;
+
+    virtual void presentNextFrame() override;
+
+    NullRendererStatistics& getStatistics();
+
+    NullBindings& getBindings();
+
+    void resetStatistics();
+
+    void printStatistics() const;
+};
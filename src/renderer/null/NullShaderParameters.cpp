@@ -0,0 +1,35 @@
+//
+//
+
+#include "NullShaderParameters.hpp"
+
+NullDescriptor::NullDescriptor()
+    : _type(DescriptorType::UniformBuffer), _texture(nullptr), _buffer(nullptr), _offset(0), _range(0) {
+}
+
+void NullDescriptor::setTexture(TextureHandle* handle) {
+    _type = DescriptorType::Texture;
+    _texture = handle;
+}
+
+void NullDescriptor::setUniformBuffer(BufferObject* object, size_t offset, size_t range) {
+    _type = DescriptorType::UniformBuffer;
+    _buffer = object;
+    _offset = offset;
+    _range = range;
+}
+
+NullDescriptorSet::NullDescriptorSet(NullRenderer* renderer, DescriptorSetType type)
+    : NullObject(renderer), _type(type) {
+}
+
+Descriptor* NullDescriptorSet::getDescriptor(DescriptorSetPart part) {
+    auto iter = _descriptors.find(part);
+    if (iter != _descriptors.end()) {
+        return iter->second.get();
+    }
+
+    auto descriptor = new NullDescriptor();
+    _descriptors.insert(std::make_pair(part, std::unique_ptr<NullDescriptor>(descriptor)));
+    return descriptor;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "renderer/ShaderParameters.hpp"
+#include "NullObject.hpp"
+
+#include <util/HashUtil.hpp>
+
+#include <memory>
+#include <unordered_map>
+
+class NullDescriptor final: public Descriptor {
+    DescriptorType _type;
+    TextureHandle* _texture;
+    BufferObject* _buffer;
+    size_t _offset;
+    size_t _range;
+ public:
+    NullDescriptor();
+    ~NullDescriptor() {}
+
+    void setTexture(TextureHandle* handle) override;
+
+    void setUniformBuffer(BufferObject* object, size_t offset, size_t range) override;
+};
+
+class NullDescriptorSet final: NullObject, public DescriptorSet {
+    DescriptorSetType _type;
+    std::unordered_map<DescriptorSetPart,
+                       std::unique_ptr<NullDescriptor>,
+                       EnumClassHash<DescriptorSetPart>> _descriptors;
+ public:
+    NullDescriptorSet(NullRenderer* renderer, DescriptorSetType type);
+    ~NullDescriptorSet() {}
+
+    Descriptor* getDescriptor(DescriptorSetPart part) override;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Counters of the null renderer. A "change" is a bind of an object that differs from the one that was bound before
+// so binds - changes is the number of redundant binds.
+struct NullRendererStatistics {
+    uint64_t frames;
+    uint64_t submits;
+    uint64_t clears;
+
+    uint64_t draw_calls;
+    uint64_t indexed_draw_calls;
+    uint64_t vertices;
+    uint64_t instances;
+
+    uint64_t pipeline_binds;
+    uint64_t pipeline_changes;
+    uint64_t vertex_array_binds;
+    uint64_t vertex_array_changes;
+    uint64_t descriptor_set_binds;
+    uint64_t descriptor_set_changes;
+    uint64_t render_target_changes;
+
+    uint64_t push_constant_updates;
+    uint64_t push_constant_bytes;
+
+    uint64_t buffer_uploads;
+    uint64_t buffer_bytes_uploaded;
+    uint64_t buffer_maps;
+
+    uint64_t texture_uploads;
+    uint64_t texture_bytes_uploaded;
+
+    uint64_t buffers_created;
+    uint64_t textures_created;
+    uint64_t descriptor_sets_created;
+    uint64_t pipelines_created;
+    uint64_t vertex_arrays_created;
+
+    NullRendererStatistics()
+        : frames(0), submits(0), clears(0), draw_calls(0), indexed_draw_calls(0), vertices(0), instances(0),
+          pipeline_binds(0), pipeline_changes(0), vertex_array_binds(0), vertex_array_changes(0),
+          descriptor_set_binds(0), descriptor_set_changes(0), render_target_changes(0), push_constant_updates(0),
+          push_constant_bytes(0), buffer_uploads(0), buffer_bytes_uploaded(0), buffer_maps(0), texture_uploads(0),
+          texture_bytes_uploaded(0), buffers_created(0), textures_created(0), descriptor_sets_created(0),
+          pipelines_created(0), vertex_arrays_created(0) {
+    }
+};
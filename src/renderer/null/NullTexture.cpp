@@ -0,0 +1,65 @@
+//
+//
+
+#include "NullTexture.hpp"
+#include "NullRenderer.hpp"
+
+NullTexture::NullTexture(NullRenderer* renderer)
+    : NullObject(renderer), _size(0, 0, 0), _format(gli::FORMAT_UNDEFINED),
+      _memory(renderer->getMemoryTracker(), MemoryCategory::Texture) {
+}
+
+void NullTexture::allocate(const AllocationProperties& props) {
+    _size = props.size;
+    _format = props.format;
+
+    _memory.setTextureAllocation(props.format,
+                                 props.target,
+                                 1,
+                                 MemoryTracker::computeTextureSize(props.format, props.target, props.size, 1));
+}
+
+void NullTexture::initialize(const gli::texture& texture, const FilterProperties&) {
+    _size = texture.extent();
+    _format = texture.format();
+
+    _memory.setTextureAllocation(texture.format(), texture.target(), texture.levels(), texture.size());
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.texture_uploads;
+    stats.texture_bytes_uploaded += texture.size();
+}
+
+void NullTexture::allocateLevels(const gli::texture& texture, const FilterProperties&) {
+    _size = texture.extent();
+    _format = texture.format();
+
+    _memory.setTextureAllocation(texture.format(), texture.target(), texture.levels(), texture.size());
+}
+
+void NullTexture::uploadLevel(const gli::texture& texture, size_t, size_t, size_t level) {
+    auto& stats = _renderer->getStatistics();
+    ++stats.texture_uploads;
+    stats.texture_bytes_uploaded += texture.size(level);
+}
+
+void NullTexture::update(const gli::extent3d&, const gli::extent3d& size, const gli::format dataFormat, const void*) {
+    auto blockExtent = gli::block_extent(dataFormat);
+    auto blocks = glm::max(size / blockExtent, gli::extent3d(1));
+
+    auto& stats = _renderer->getStatistics();
+    ++stats.texture_uploads;
+    stats.texture_bytes_uploaded += (uint64_t) blocks.x * blocks.y * blocks.z * gli::block_size(dataFormat);
+}
+
+gli::extent3d NullTexture::getSize() const {
+    return _size;
+}
+
+void NullTexture::setDebugName(const std::string& name) {
+    _memory.setName(name);
+}
+
+void NullTexture::markAsRenderTarget() {
+    _memory.setCategory(MemoryCategory::RenderTarget);
+}
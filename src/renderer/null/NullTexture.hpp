@@ -0,0 +1,35 @@
+#pragma once
+
+#include "renderer/Texture.hpp"
+#include "renderer/MemoryTracker.hpp"
+#include "NullObject.hpp"
+
+class NullTexture final: NullObject, public Texture {
+    gli::extent3d _size;
+    gli::format _format;
+
+    TrackedMemory _memory;
+ public:
+    explicit NullTexture(NullRenderer* renderer);
+    ~NullTexture() {}
+
+    void allocate(const AllocationProperties& props) override;
+
+    void initialize(const gli::texture& texture, const FilterProperties& filterProperties) override;
+
+    void allocateLevels(const gli::texture& texture, const FilterProperties& filterProperties) override;
+
+    void uploadLevel(const gli::texture& texture, size_t layer, size_t face, size_t level) override;
+
+    void update(const gli::extent3d& position,
+                const gli::extent3d& size,
+                const gli::format dataFormat,
+                const void* data) override;
+
+    gli::extent3d getSize() const override;
+
+    void setDebugName(const std::string& name) override;
+
+    // Moves the memory of this texture into the render target category of the memory statistics
+    void markAsRenderTarget();
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "renderer/VertexLayout.hpp"
+
+class NullVertexArrayObject final: public VertexArrayObject {
+    bool _hasIndices;
+ public:
+    explicit NullVertexArrayObject(const VertexArrayProperties& props) : _hasIndices(props.indexBuffer != nullptr) {}
+    ~NullVertexArrayObject() {}
+
+    bool hasIndices() const {
+        return _hasIndices;
+    }
+};
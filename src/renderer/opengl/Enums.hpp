@@ -43,6 +43,8 @@ enum class GL3DescriptorSetPart {
     NanoVGGlobalSet_Uniforms,
 
     NanoVGLocalSet_Uniforms,
-    NanoVGLocalSet_Texture
+    NanoVGLocalSet_Texture,
+
+    NUM_VALUES
 };
 HASHABLE_ENUMCLASS(GL3DescriptorSetPart)
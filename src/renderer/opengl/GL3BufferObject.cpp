@@ -5,6 +5,7 @@
 #include <util/Assertion.hpp>
 #include "GL3BufferObject.hpp"
 #include "GL3State.hpp"
+#include "GL3Renderer.hpp"
 
 namespace {
     GLenum getGLType(BufferType type) {
@@ -22,12 +23,14 @@ namespace {
     }
 }
 
-GL3BufferObject::GL3BufferObject(BufferType type) {
+GL3BufferObject::GL3BufferObject(GL3Renderer* renderer, BufferType type)
+    : GL3Object(renderer), _type(type), _memory(renderer->getMemoryTracker(), MemoryCategory::Buffer),
+      _immutableStorage(false), _persistentPointer(nullptr) {
     glGenBuffers(1, &_handle);
-    _type = type;
 }
 
 GL3BufferObject::~GL3BufferObject() {
+    GLState->Buffer.bufferDeleted(_handle);
     glDeleteBuffers(1, &_handle);
 }
 
@@ -52,25 +55,7 @@ void GL3BufferObject::bind() {
     }
 }
 
-void GL3BufferObject::setData(const void *data, size_t size, BufferUsage usage) {
-    this->bind();
-
-    GLenum gl_usage;
-    switch (usage) {
-        case BufferUsage::Static:
-            gl_usage = GL_STATIC_DRAW;
-            break;
-        case BufferUsage::Dynamic:
-            gl_usage = GL_DYNAMIC_DRAW;
-            break;
-        case BufferUsage::Streaming:
-            gl_usage = GL_STREAM_DRAW;
-            break;
-    }
-
-    GLenum gl_type = getGLType(_type);
-    glBufferData(gl_type, size, data, gl_usage);
-
+void GL3BufferObject::unbind() {
     switch(_type) {
         case BufferType::None:
             return;
@@ -86,7 +71,84 @@ void GL3BufferObject::setData(const void *data, size_t size, BufferUsage usage)
     }
 }
 
+void GL3BufferObject::setData(const void *data, size_t size, BufferUsage usage) {
+    if (_immutableStorage) {
+        // The storage of this buffer can't be changed anymore so we need a new buffer. Deleting the buffer also removes
+        // the persistent mapping.
+        GLState->Buffer.bufferDeleted(_handle);
+        glDeleteBuffers(1, &_handle);
+        glGenBuffers(1, &_handle);
+
+        _immutableStorage = false;
+    }
+    _persistentPointer = nullptr;
+    _shadowData.clear();
+    _shadowData.shrink_to_fit();
+
+    this->bind();
+
+    if (usage == BufferUsage::PersistentStreaming) {
+        setPersistentData(data, size);
+    } else {
+        GLenum gl_usage;
+        switch (usage) {
+            case BufferUsage::Static:
+                gl_usage = GL_STATIC_DRAW;
+                break;
+            case BufferUsage::Dynamic:
+                gl_usage = GL_DYNAMIC_DRAW;
+                break;
+            default:
+                gl_usage = GL_STREAM_DRAW;
+                break;
+        }
+
+        glBufferData(getGLType(_type), size, data, gl_usage);
+    }
+
+    if (data != nullptr) {
+        ++GLFrameStatistics.buffer_uploads;
+        GLFrameStatistics.buffer_upload_bytes += size;
+    }
+
+    _memory.setBufferAllocation(_type, usage, size);
+    applyDebugName();
+
+    unbind();
+}
+
+void GL3BufferObject::setPersistentData(const void* data, size_t size) {
+    Assertion(size > 0, "Size may not be zero!");
+
+    GLenum gl_type = getGLType(_type);
+
+    if (GLAD_GL_ARB_buffer_storage) {
+        // Coherent mapping makes writes visible to the GPU without explicit flushes
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage(gl_type, size, data, flags);
+        _immutableStorage = true;
+
+        _persistentPointer = glMapBufferRange(gl_type, 0, size, flags);
+        Assertion(_persistentPointer != nullptr, "Persistent mapping of buffer failed!");
+        return;
+    }
+
+    glBufferData(gl_type, size, data, GL_STREAM_DRAW);
+
+    _shadowData.resize(size);
+    if (data != nullptr) {
+        std::memcpy(_shadowData.data(), data, size);
+    }
+    _persistentPointer = _shadowData.data();
+}
+
 void GL3BufferObject::updateData(const void *data, size_t offset, size_t size, UpdateFlags flags) {
+    Assertion(_persistentPointer == nullptr, "Persistent buffers have to be written through the persistent pointer!");
+
+    ++GLFrameStatistics.buffer_uploads;
+    GLFrameStatistics.buffer_upload_bytes += size;
+
     this->bind();
     if (_type == BufferType::Uniform) {
         // Prefer to use buffer sub data for uniform buffers
@@ -112,6 +174,7 @@ void GL3BufferObject::updateData(const void *data, size_t offset, size_t size, U
 void* GL3BufferObject::map(size_t offset, size_t size, BufferMapFlags flags)
 {
     Assertion(size > 0, "Size may not be zero!");
+    Assertion(_persistentPointer == nullptr, "Persistent buffers can't be mapped, use the persistent pointer instead!");
 
     GLbitfield gl_flags = 0;
     if (flags & BufferMapFlags::Read)
@@ -126,6 +189,10 @@ void* GL3BufferObject::map(size_t offset, size_t size, BufferMapFlags flags)
     {
         gl_flags |= GL_MAP_INVALIDATE_RANGE_BIT;
     }
+    if (flags & BufferMapFlags::Unsynchronized)
+    {
+        gl_flags |= GL_MAP_UNSYNCHRONIZED_BIT;
+    }
 
     this->bind();
     return glMapBufferRange(getGLType(_type), offset, size, gl_flags);
@@ -136,3 +203,56 @@ bool GL3BufferObject::unmap()
     this->bind();
     return glUnmapBuffer(getGLType(_type)) == GL_TRUE;
 }
+
+void* GL3BufferObject::getPersistentPointer() {
+    Assertion(_persistentPointer != nullptr, "Buffer was not created with persistent streaming usage!");
+    return _persistentPointer;
+}
+
+void GL3BufferObject::setDebugName(const std::string& name) {
+    _debugName = name;
+    _memory.setName(name);
+
+    applyDebugName();
+}
+
+void GL3BufferObject::applyDebugName() {
+    // The buffer object only exists after it was bound for the first time
+    if (_debugName.empty() || !GLAD_GL_KHR_debug || !glIsBuffer(_handle)) {
+        return;
+    }
+
+    glObjectLabelKHR(GL_BUFFER_KHR, _handle, (GLsizei) _debugName.size(), _debugName.c_str());
+}
+
+void GL3BufferObject::flushPersistentRange(size_t offset, size_t size) {
+    Assertion(_persistentPointer != nullptr, "Buffer was not created with persistent streaming usage!");
+    Assertion(size > 0, "Size may not be zero!");
+
+    ++GLFrameStatistics.buffer_uploads;
+    GLFrameStatistics.buffer_upload_bytes += size;
+
+    if (_immutableStorage) {
+        // The mapping is coherent so the data is already visible
+        return;
+    }
+
+    Assertion(offset + size <= _shadowData.size(), "Flushed range is out of bounds!");
+
+    // The caller guarantees that the range is not in use anymore so the driver does not need to synchronize
+    this->bind();
+    GLenum gl_type = getGLType(_type);
+    auto ptr = glMapBufferRange(gl_type,
+                                offset,
+                                size,
+                                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (ptr != nullptr) {
+        std::memcpy(ptr, _shadowData.data() + offset, size);
+
+        if (glUnmapBuffer(gl_type) == GL_TRUE) {
+            return;
+        }
+    }
+    // The mapping failed or its contents were lost so the data has to be uploaded again
+    glBufferSubData(gl_type, offset, size, _shadowData.data() + offset);
+}
@@ -1,15 +1,41 @@
 #pragma once
 
 #include "renderer/BufferObject.hpp"
+#include "renderer/MemoryTracker.hpp"
+#include "GL3Object.hpp"
 
 #include <glad/glad.h>
+#include <string>
 #include <utility>
+#include <vector>
+#include <cstdint>
 
-class GL3BufferObject final: public BufferObject {
+class GL3BufferObject final: public GL3Object, public BufferObject {
     GLuint _handle;
     BufferType _type;
+
+    TrackedMemory _memory;
+    std::string _debugName;
+
+    // Set if the storage was created with glBufferStorage. Immutable storage can't be respecified so setData has to
+    // create a new buffer object.
+    bool _immutableStorage;
+
+    // Pointer returned by getPersistentPointer(). Points either into the persistent mapping or into _shadowData.
+    void* _persistentPointer;
+
+    // Without ARB_buffer_storage the buffer can't stay mapped while it is used for drawing. Writers get a pointer into
+    // this copy instead and flushPersistentRange copies the written range into the buffer with an unsynchronized map.
+    std::vector<uint8_t> _shadowData;
+
+    void unbind();
+
+    void setPersistentData(const void* data, size_t size);
+
+    // Labels are attached to the buffer object so they have to be applied again if the object is recreated
+    void applyDebugName();
  public:
-    explicit GL3BufferObject(BufferType type);
+    GL3BufferObject(GL3Renderer* renderer, BufferType type);
     ~GL3BufferObject();
 
     void bind();
@@ -27,6 +53,12 @@ class GL3BufferObject final: public BufferObject {
     void* map(size_t size, size_t offset, BufferMapFlags flags) override;
 
     bool unmap() override;
+
+    void* getPersistentPointer() override;
+
+    void flushPersistentRange(size_t offset, size_t size) override;
+
+    void setDebugName(const std::string& name) override;
 };
 
 
@@ -10,7 +10,15 @@
 #include "GL3ShaderParameters.hpp"
 
 
-GL3CommandBuffer::GL3CommandBuffer(GL3Renderer* renderer) : GL3Object(renderer), _currentPrimitiveType(GL_NONE) {
+GL3CommandBuffer::GL3CommandBuffer(GL3Renderer* renderer) : GL3Object(renderer) {
+}
+
+CommandBufferMode GL3CommandBuffer::getMode() const {
+    return CommandBufferMode::Immediate;
+}
+
+void GL3CommandBuffer::reset() {
+    // Commands are executed immediately so there is nothing to discard
 }
 
 void GL3CommandBuffer::clear(const glm::vec4& color, ClearTarget target) {
@@ -52,7 +60,9 @@ void GL3CommandBuffer::bindPipeline(PointerWrapper<PipelineState> pipeline) {
     auto glState = static_cast<GL3PipelineState*>(&pipeline);
 
     glState->setupState();
-    _currentPrimitiveType = glState->getPrimitiveType();
+    GLState->setPrimitiveType(glState->getPrimitiveType());
+
+    ++GLFrameStatistics.pipeline_binds;
 }
 
 void GL3CommandBuffer::bindVertexArrayObject(PointerWrapper<VertexArrayObject> vao) {
@@ -69,7 +79,7 @@ void GL3CommandBuffer::bindVertexArrayObject(PointerWrapper<VertexArrayObject> v
 
     glVao->bind();
 
-    _vao = glVao;
+    GLState->setDrawVertexArray(glVao);
 }
 
 void GL3CommandBuffer::pushConstants(void* data, size_t size) {
@@ -87,9 +97,10 @@ void GL3CommandBuffer::pushConstants(void* data, size_t size) {
 void
 GL3CommandBuffer::draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexOffset, uint32_t baseInstance) {
     Assertion(baseInstance == 0, "Base instance it not implemented!");
-    Assertion(_vao, "A Vertex Array Object has to be set for drawing!");
+    Assertion(GLState->getDrawVertexArray(), "A Vertex Array Object has to be set for drawing!");
 
-    glDrawArraysInstanced(_currentPrimitiveType, vertexOffset, vertexCount, instanceCount);
+    glDrawArraysInstanced(GLState->getPrimitiveType(), vertexOffset, vertexCount, instanceCount);
+    ++GLFrameStatistics.draw_calls;
 }
 
 void GL3CommandBuffer::drawIndexed(uint32_t indexCount,
@@ -97,18 +108,21 @@ void GL3CommandBuffer::drawIndexed(uint32_t indexCount,
                                    uint32_t indexOffset,
                                    uint32_t baseVertex,
                                    uint32_t baseInstance) {
+    auto vao = GLState->getDrawVertexArray();
+
     Assertion(baseInstance == 0, "Base instance it not implemented!");
-    Assertion(_vao, "A Vertex Array Object has to be set for drawing!");
-    Assertion(_vao->getIndexType() != GL_NONE, "Vertex Array Object needs index information for indexed rendering!");
+    Assertion(vao, "A Vertex Array Object has to be set for drawing!");
+    Assertion(vao->getIndexType() != GL_NONE, "Vertex Array Object needs index information for indexed rendering!");
 
-    auto indices = _vao->computeIndexOffset(indexOffset);
+    auto indices = vao->computeIndexOffset(indexOffset);
 
-    glDrawElementsInstancedBaseVertex(_currentPrimitiveType,
+    glDrawElementsInstancedBaseVertex(GLState->getPrimitiveType(),
                                       indexCount,
-                                      _vao->getIndexType(),
+                                      vao->getIndexType(),
                                       indices,
                                       instanceCount,
                                       baseVertex);
+    ++GLFrameStatistics.draw_calls;
 }
 void GL3CommandBuffer::bindDescriptorSet(PointerWrapper<DescriptorSet> set) {
     if (false) {
@@ -123,6 +137,8 @@ void GL3CommandBuffer::bindDescriptorSet(PointerWrapper<DescriptorSet> set) {
     auto glSet = static_cast<GL3DescriptorSet*>(&set);
 
     glSet->bind();
+
+    ++GLFrameStatistics.descriptor_set_binds;
 }
 void GL3CommandBuffer::unbindDescriptorSet(PointerWrapper<DescriptorSet> set) {
     if (false) {
@@ -8,12 +8,14 @@
 
 class GL3CommandBuffer final: public CommandBuffer, GL3Object
 {
-    GLenum _currentPrimitiveType;
-    GL3VertexArrayObject* _vao;
 public:
     explicit GL3CommandBuffer(GL3Renderer* renderer);
     ~GL3CommandBuffer() {}
 
+    CommandBufferMode getMode() const override;
+
+    void reset() override;
+
     void clear(const glm::vec4& color, ClearTarget target) override;
 
     void bindPipeline(PointerWrapper<PipelineState> pipeline) override;
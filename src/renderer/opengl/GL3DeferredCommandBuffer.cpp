@@ -0,0 +1,196 @@
+//
+//
+
+#include "GL3DeferredCommandBuffer.hpp"
+#include "GL3CommandBuffer.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace {
+// All packets start at this alignment so the payload structs can be read in place
+const size_t PACKET_ALIGNMENT = 8;
+
+size_t alignPacketSize(size_t size) {
+    return (size + PACKET_ALIGNMENT - 1) & ~(PACKET_ALIGNMENT - 1);
+}
+
+struct ClearPacket {
+    glm::vec4 color;
+    ClearTarget target;
+};
+
+struct PipelinePacket {
+    PipelineState* pipeline;
+};
+
+struct VertexArrayObjectPacket {
+    VertexArrayObject* vao;
+};
+
+struct DescriptorSetPacket {
+    DescriptorSet* set;
+};
+
+struct PushConstantsPacket {
+    uint32_t size;
+    // The constant data follows directly after this struct
+};
+
+struct DrawPacket {
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t vertexOffset;
+    uint32_t baseInstance;
+};
+
+struct DrawIndexedPacket {
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t indexOffset;
+    uint32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+static_assert(std::is_trivially_copyable<ClearPacket>::value, "Packets must be POD!");
+static_assert(std::is_trivially_copyable<PipelinePacket>::value, "Packets must be POD!");
+static_assert(std::is_trivially_copyable<VertexArrayObjectPacket>::value, "Packets must be POD!");
+static_assert(std::is_trivially_copyable<DescriptorSetPacket>::value, "Packets must be POD!");
+static_assert(std::is_trivially_copyable<PushConstantsPacket>::value, "Packets must be POD!");
+static_assert(std::is_trivially_copyable<DrawPacket>::value, "Packets must be POD!");
+static_assert(std::is_trivially_copyable<DrawIndexedPacket>::value, "Packets must be POD!");
+
+const size_t HEADER_SIZE = alignPacketSize(sizeof(GL3DeferredCommandBuffer::PacketHeader));
+}
+
+GL3DeferredCommandBuffer::GL3DeferredCommandBuffer(GL3Renderer* renderer) : GL3Object(renderer) {
+    // Enough for a typical scene pass without reallocating
+    _packets.reserve(4096);
+}
+
+CommandBufferMode GL3DeferredCommandBuffer::getMode() const {
+    return CommandBufferMode::Deferred;
+}
+
+void GL3DeferredCommandBuffer::reset() {
+    // Keeps the capacity of the packet storage
+    _packets.clear();
+}
+
+void* GL3DeferredCommandBuffer::allocatePacket(GL3CommandType type, size_t payloadSize) {
+    auto packetSize = HEADER_SIZE + alignPacketSize(payloadSize);
+    auto offset = _packets.size();
+
+    _packets.resize(offset + packetSize);
+
+    auto header = reinterpret_cast<PacketHeader*>(_packets.data() + offset);
+    header->type = type;
+    header->size = static_cast<uint32_t>(packetSize);
+
+    return _packets.data() + offset + HEADER_SIZE;
+}
+
+void GL3DeferredCommandBuffer::clear(const glm::vec4& color, ClearTarget target) {
+    auto packet = allocatePacket<ClearPacket>(GL3CommandType::Clear);
+    packet->color = color;
+    packet->target = target;
+}
+
+void GL3DeferredCommandBuffer::bindPipeline(PointerWrapper<PipelineState> pipeline) {
+    allocatePacket<PipelinePacket>(GL3CommandType::BindPipeline)->pipeline = pipeline;
+}
+
+void GL3DeferredCommandBuffer::bindVertexArrayObject(PointerWrapper<VertexArrayObject> vao) {
+    allocatePacket<VertexArrayObjectPacket>(GL3CommandType::BindVertexArrayObject)->vao = vao;
+}
+
+void GL3DeferredCommandBuffer::bindDescriptorSet(PointerWrapper<DescriptorSet> set) {
+    allocatePacket<DescriptorSetPacket>(GL3CommandType::BindDescriptorSet)->set = set;
+}
+
+void GL3DeferredCommandBuffer::unbindDescriptorSet(PointerWrapper<DescriptorSet> set) {
+    allocatePacket<DescriptorSetPacket>(GL3CommandType::UnbindDescriptorSet)->set = set;
+}
+
+void GL3DeferredCommandBuffer::pushConstants(void* data, size_t size) {
+    // The data is copied into the packet since the caller usually passes a pointer to a stack variable
+    auto packet = static_cast<PushConstantsPacket*>(allocatePacket(GL3CommandType::PushConstants,
+                                                                   sizeof(PushConstantsPacket) + size));
+    packet->size = static_cast<uint32_t>(size);
+    std::memcpy(packet + 1, data, size);
+}
+
+void GL3DeferredCommandBuffer::draw(uint32_t vertexCount,
+                                    uint32_t instanceCount,
+                                    uint32_t vertexOffset,
+                                    uint32_t baseInstance) {
+    auto packet = allocatePacket<DrawPacket>(GL3CommandType::Draw);
+    packet->vertexCount = vertexCount;
+    packet->instanceCount = instanceCount;
+    packet->vertexOffset = vertexOffset;
+    packet->baseInstance = baseInstance;
+}
+
+void GL3DeferredCommandBuffer::drawIndexed(uint32_t indexCount,
+                                           uint32_t instanceCount,
+                                           uint32_t indexOffset,
+                                           uint32_t baseVertex,
+                                           uint32_t baseInstance) {
+    auto packet = allocatePacket<DrawIndexedPacket>(GL3CommandType::DrawIndexed);
+    packet->indexCount = indexCount;
+    packet->instanceCount = instanceCount;
+    packet->indexOffset = indexOffset;
+    packet->baseVertex = baseVertex;
+    packet->baseInstance = baseInstance;
+}
+
+void GL3DeferredCommandBuffer::execute(GL3CommandBuffer* target) const {
+    auto current = _packets.data();
+    auto end = current + _packets.size();
+
+    while (current < end) {
+        auto header = reinterpret_cast<const PacketHeader*>(current);
+        auto payload = current + HEADER_SIZE;
+
+        switch (header->type) {
+            case GL3CommandType::Clear: {
+                auto packet = reinterpret_cast<const ClearPacket*>(payload);
+                target->clear(packet->color, packet->target);
+                break;
+            }
+            case GL3CommandType::BindPipeline:
+                target->bindPipeline(reinterpret_cast<const PipelinePacket*>(payload)->pipeline);
+                break;
+            case GL3CommandType::BindVertexArrayObject:
+                target->bindVertexArrayObject(reinterpret_cast<const VertexArrayObjectPacket*>(payload)->vao);
+                break;
+            case GL3CommandType::BindDescriptorSet:
+                target->bindDescriptorSet(reinterpret_cast<const DescriptorSetPacket*>(payload)->set);
+                break;
+            case GL3CommandType::UnbindDescriptorSet:
+                target->unbindDescriptorSet(reinterpret_cast<const DescriptorSetPacket*>(payload)->set);
+                break;
+            case GL3CommandType::PushConstants: {
+                auto packet = reinterpret_cast<const PushConstantsPacket*>(payload);
+                target->pushConstants(const_cast<PushConstantsPacket*>(packet + 1), packet->size);
+                break;
+            }
+            case GL3CommandType::Draw: {
+                auto packet = reinterpret_cast<const DrawPacket*>(payload);
+                target->draw(packet->vertexCount, packet->instanceCount, packet->vertexOffset, packet->baseInstance);
+                break;
+            }
+            case GL3CommandType::DrawIndexed: {
+                auto packet = reinterpret_cast<const DrawIndexedPacket*>(payload);
+                target->drawIndexed(packet->indexCount,
+                                    packet->instanceCount,
+                                    packet->indexOffset,
+                                    packet->baseVertex,
+                                    packet->baseInstance);
+                break;
+            }
+        }
+
+        current += header->size;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <renderer/CommandBuffer.hpp>
+#include "GL3Object.hpp"
+
+#include <vector>
+#include <cstdint>
+
+class GL3CommandBuffer;
+
+enum class GL3CommandType : uint32_t {
+    Clear,
+    BindPipeline,
+    BindVertexArrayObject,
+    BindDescriptorSet,
+    UnbindDescriptorSet,
+    PushConstants,
+    Draw,
+    DrawIndexed
+};
+
+// Records commands into a linear stream of POD packets without touching any GL state. The packets reference the
+// recorded objects by pointer so these objects must stay alive until the last submit of this buffer.
+class GL3DeferredCommandBuffer final: public CommandBuffer, GL3Object {
+ public:
+    struct PacketHeader {
+        GL3CommandType type;
+        uint32_t size; // Size of the packet including this header and padding
+    };
+
+ private:
+    std::vector<uint8_t> _packets;
+
+    void* allocatePacket(GL3CommandType type, size_t payloadSize);
+
+    template<typename T>
+    T* allocatePacket(GL3CommandType type) {
+        return static_cast<T*>(allocatePacket(type, sizeof(T)));
+    }
+
+ public:
+    explicit GL3DeferredCommandBuffer(GL3Renderer* renderer);
+    ~GL3DeferredCommandBuffer() {}
+
+    CommandBufferMode getMode() const override;
+
+    void reset() override;
+
+    void clear(const glm::vec4& color, ClearTarget target) override;
+
+    void bindPipeline(PointerWrapper<PipelineState> pipeline) override;
+
+    void bindVertexArrayObject(PointerWrapper<VertexArrayObject> vao) override;
+
+    void bindDescriptorSet(PointerWrapper<DescriptorSet> set) override;
+
+    void unbindDescriptorSet(PointerWrapper<DescriptorSet> set) override;
+
+    void pushConstants(void* data, size_t size) override;
+
+    void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t vertexOffset, uint32_t baseInstance) override;
+
+    void drawIndexed(uint32_t indexCount,
+                     uint32_t instanceCount,
+                     uint32_t indexOffset,
+                     uint32_t baseVertex,
+                     uint32_t baseInstance) override;
+
+    // Replays all recorded packets on the given immediate command buffer. Must be called on the GL thread.
+    void execute(GL3CommandBuffer* target) const;
+};
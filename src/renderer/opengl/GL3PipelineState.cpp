@@ -76,92 +76,79 @@ GLenum convertPrimitiveType(PrimitiveType type) {
     }
     return GL_TRIANGLES;
 }
+uint64_t packStencilOps(const std::tuple<StencilOperation, StencilOperation, StencilOperation>& ops) {
+    return uint64_t(convertStencilOp(std::get<0>(ops))) | uint64_t(convertStencilOp(std::get<1>(ops))) << 16
+        | uint64_t(convertStencilOp(std::get<2>(ops))) << 32;
 }
+GL3StateBlock createStateBlock(const PipelineProperties& props) {
+    GL3StateBlock block;
 
-void GL3PipelineState::setupState() {
-    GLState->Program.use(_props.shaderHandle);
-
-    switch (_props.depthMode) {
+    bool depthTest = false;
+    bool depthMask = false;
+    auto depthFunction = props.depthFunction;
+    switch (props.depthMode) {
         case DepthMode::None:
-            // Disable read and write
-            GLState->setDepthTest(false);
-            GLState->setDepthMask(false);
+            // Disable read and write. The function is irrelevant so it is fixed to keep equivalent blocks equal.
+            depthFunction = ComparisionFunction::Always;
             break;
         case DepthMode::Read:
             // Enable read and disable write
-            GLState->setDepthTest(true);
-            GLState->setDepthFunc(_props.depthFunction);
-            GLState->setDepthMask(false);
+            depthTest = true;
             break;
         case DepthMode::Write:
             // Disable read and enable write
             // "Even if the depth buffer exists and the depth mask is non-zero, the depth buffer is not updated if the depth test is disabled."
             // From the OpenGL Spec. That means that we have to enable the depth test even though we don't want to use it
             // instead we set the depth function to always accept which should have the same effect
-            GLState->setDepthTest(true);
-            GLState->setDepthFunc(ComparisionFunction::Always);
-            GLState->setDepthMask(true);
+            depthTest = true;
+            depthMask = true;
+            depthFunction = ComparisionFunction::Always;
             break;
         case DepthMode::ReadWrite:
             // Enable read and write
-            GLState->setDepthTest(true);
-            GLState->setDepthFunc(_props.depthFunction);
-            GLState->setDepthMask(true);
+            depthTest = true;
+            depthMask = true;
             break;
     }
+    block.depth = uint64_t(depthTest) | uint64_t(depthMask) << 1 | uint64_t(depthFunction) << 8;
 
-    GLState->setBlendMode(_props.enableBlending);
-    GLState->setBlendFunc(_props.blendFunction);
-
-    GLState->Stencil.setStencilTest(_props.enableStencil);
-    GLState->Stencil.setStencilMask(_props.stencilMask);
-    GLState->Stencil.setStencilFunc(_props.stencilFunc);
-    GLState->Stencil.setFrontStencilOp(_props.frontStencilOp);
-    GLState->Stencil.setBackStencilOp(_props.backStencilOp);
-
-    GLState->setScissorTest(_props.enableScissor);
+    block.blend = uint64_t(props.enableBlending) | uint64_t(props.blendFunction) << 8;
 
-    GLState->CullFace.setFaceCulling(_props.enableFaceCulling);
-    GLState->CullFace.setCulledFace(_props.culledFace);
-    GLState->CullFace.setFrontFace(_props.frontFace);
+    block.stencil[0] = uint64_t(props.enableStencil)
+        | uint64_t(convertComparisionFunction(std::get<0>(props.stencilFunc))) << 16
+        | uint64_t(props.stencilMask) << 32;
+    block.stencil[1] = uint64_t(std::get<1>(props.stencilFunc)) | uint64_t(std::get<2>(props.stencilFunc)) << 32;
+    block.stencil[2] = packStencilOps(props.frontStencilOp);
+    block.stencil[3] = packStencilOps(props.backStencilOp);
 
-    GLState->setColorMask(_props.colorMask);
-}
-
-GL3PipelineState::GL3PipelineState(GL3Renderer* renderer, const PipelineProperties& props) : GL3Object(renderer) {
-    _props.shaderHandle = _renderer->getShaderManager()->getProgram(props.shaderType, props.shaderFlags);
+    block.cullFace = uint64_t(props.enableFaceCulling) | uint64_t(convertCulledFace(props.culledFace)) << 16
+        | uint64_t(convertFrontFace(props.frontFace)) << 32;
 
-    _props.primitiveType = convertPrimitiveType(props.primitive_type);
+    block.colorMask = uint64_t(props.colorMask.r) | uint64_t(props.colorMask.g) << 1
+        | uint64_t(props.colorMask.b) << 2 | uint64_t(props.colorMask.a) << 3;
 
-    _props.depthMode = props.depthMode;
-    _props.depthFunction = props.depthFunction;
+    block.scissor = uint64_t(props.enableScissor);
 
-    _props.enableBlending = props.enableBlending;
-    _props.blendFunction = props.blendFunction;
-
-    _props.enableFaceCulling = props.enableFaceCulling;
-    _props.culledFace = convertCulledFace(props.culledFace);
-    _props.frontFace = convertFrontFace(props.frontFace);
+    return block;
+}
+}
 
-    _props.enableScissor = props.enableScissor;
+void GL3PipelineStateObject::setupState() {
+    GLState->Program.use(_props.shaderHandle);
 
-    _props.enableStencil = props.enableStencil;
-    _props.stencilMask = props.stencilMask;
+    GLState->applyStateBlock(_props.stateBlock);
+}
 
-    _props.frontStencilOp = std::make_tuple(convertStencilOp(std::get<0>(props.frontStencilOp)),
-                                            convertStencilOp(std::get<1>(props.frontStencilOp)),
-                                            convertStencilOp(std::get<2>(props.frontStencilOp)));
-    _props.backStencilOp = std::make_tuple(convertStencilOp(std::get<0>(props.backStencilOp)),
-                                           convertStencilOp(std::get<1>(props.backStencilOp)),
-                                           convertStencilOp(std::get<2>(props.backStencilOp)));
+GL3PipelineStateObject::GL3PipelineStateObject(GL3Renderer* renderer, const PipelineProperties& props)
+    : GL3Object(renderer) {
+    _props.shaderHandle = _renderer->getShaderManager()->getProgram(props.shaderType, props.shaderFlags);
 
-    _props.stencilFunc = std::make_tuple(convertComparisionFunction(std::get<0>(props.stencilFunc)),
-                                         std::get<1>(props.stencilFunc),
-                                         std::get<2>(props.stencilFunc));
+    _props.primitiveType = convertPrimitiveType(props.primitive_type);
 
-    _props.colorMask = props.colorMask;
+    _props.stateBlock = createStateBlock(props);
 
-    // Issue a dummy draw call for less frame drops later (if the driver actually uses this information)
+    // Issue a dummy draw call for less frame drops later (if the driver actually uses this information). This only
+    // happens once per unique pipeline because of the pipeline cache.
     // TODO: This could use a correct VAO created from the input state
     setupState();
     GLuint vao;
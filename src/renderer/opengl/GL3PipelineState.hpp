@@ -3,48 +3,61 @@
 #include "renderer/PipelineState.hpp"
 #include "Enums.hpp"
 #include "GL3Object.hpp"
+#include "GL3State.hpp"
 
 #include <glad/glad.h>
 
+#include <memory>
+
 struct GL3PipelineProperties {
     GLuint shaderHandle;
 
     GLenum primitiveType;
-    DepthMode depthMode;
-    ComparisionFunction depthFunction;
 
-    bool enableBlending;
-    BlendFunction blendFunction;
+    GL3StateBlock stateBlock;
+};
 
-    bool enableFaceCulling;
-    GLenum culledFace;
-    GLenum frontFace;
+// The actual pipeline object. Identical pipeline properties share one of these through the pipeline cache of the
+// renderer.
+class GL3PipelineStateObject final: public GL3Object {
+    GL3PipelineProperties _props;
+ public:
+    GL3PipelineStateObject(GL3Renderer* renderer, const PipelineProperties& props);
 
-    bool enableScissor;
+    ~GL3PipelineStateObject() { }
 
-    bool enableStencil;
-    uint32_t stencilMask;
+    void setupState();
 
-    std::tuple<GLenum, GLenum, GLenum> frontStencilOp;
-    std::tuple<GLenum, GLenum, GLenum> backStencilOp;
-    std::tuple<GLenum, uint32_t, uint32_t> stencilFunc;
+    GLenum getPrimitiveType() const
+    {
+        return _props.primitiveType;
+    }
 
-    glm::bvec4 colorMask;
+    const GL3StateBlock& getStateBlock() const
+    {
+        return _props.stateBlock;
+    }
 };
 
-class GL3PipelineState final: public GL3Object, public PipelineState {
-    GL3PipelineProperties _props;
+class GL3PipelineState final: public PipelineState {
+    std::shared_ptr<GL3PipelineStateObject> _object;
  public:
-    GL3PipelineState(GL3Renderer* renderer, const PipelineProperties& props);
+    explicit GL3PipelineState(const std::shared_ptr<GL3PipelineStateObject>& object) : _object(object) { }
 
     virtual ~GL3PipelineState() { }
 
-    void setupState();
+    void setupState()
+    {
+        _object->setupState();
+    }
 
     GLenum getPrimitiveType() const
     {
-        return _props.primitiveType;
+        return _object->getPrimitiveType();
     }
-};
-
 
+    const GL3StateBlock& getStateBlock() const
+    {
+        return _object->getStateBlock();
+    }
+};
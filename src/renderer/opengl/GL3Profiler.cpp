@@ -1,6 +1,7 @@
 #include <util/Assertion.hpp>
 #include "GL3Profiler.hpp"
 #include "GL3Renderer.hpp"
+#include "GL3State.hpp"
 
 #include <SDL_timer.h>
 
@@ -134,3 +135,11 @@ std::vector<ProfilingResult> GL3Profiler::getResults() {
     return results;
 }
 
+FrameStatistics GL3Profiler::getFrameStatistics() {
+    return _lastFrameStatistics;
+}
+
+void GL3Profiler::frameFinished() {
+    _lastFrameStatistics = GLFrameStatistics;
+    GLFrameStatistics = FrameStatistics();
+}
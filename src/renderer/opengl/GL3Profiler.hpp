@@ -51,6 +51,8 @@ class GL3Profiler final: public Profiler, public GL3Object {
     std::vector<std::unique_ptr<GL3ProfilingCategory>> _categories;
 
     uint64_t _cpuTimeFrequency;
+
+    FrameStatistics _lastFrameStatistics;
  public:
     GL3Profiler(GL3Renderer* renderer);
 
@@ -60,6 +62,11 @@ class GL3Profiler final: public Profiler, public GL3Object {
 
     std::vector<ProfilingResult> getResults() override;
 
+    FrameStatistics getFrameStatistics() override;
+
+    // Stores the statistics of the current frame and starts counting the next one
+    void frameFinished();
+
     GLuint getQueryObject();
 
     void freeQueryObject(GLuint query);
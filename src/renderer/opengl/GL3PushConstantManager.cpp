@@ -5,27 +5,15 @@
 #include "GL3Renderer.hpp"
 #include "EnumTranslation.hpp"
 
-GL3PushConstantManager::GL3PushConstantManager(GL3Renderer* renderer) : GL3Object(renderer), _bufferSize(9) {
-    _pushConstantBuffer.reset(static_cast<GL3BufferObject*>(renderer->createBuffer(BufferType::Uniform).release()));
-
-    ensureBufferSize(128);
-}
-
-void GL3PushConstantManager::ensureBufferSize(size_t size) {
-    if (_bufferSize >= size) {
-        return;
-    }
-
-    _pushConstantBuffer->setData(nullptr, size, BufferUsage::Streaming);
+GL3PushConstantManager::GL3PushConstantManager(GL3Renderer* renderer) : GL3Object(renderer) {
 }
 
 void GL3PushConstantManager::setConstants(void* data, size_t size) {
-    ensureBufferSize(size);
-
-    _pushConstantBuffer->updateData(data, 0, size, UpdateFlags::DiscardOldData);
+    auto range = _renderer->getUniformRingBuffer()->upload(data, size);
 
-    glBindBufferRange(GL_UNIFORM_BUFFER,
-                      mapDescriptorSetPartLocation(GL3DescriptorSetPart::PushConstantSet_Uniforms),
-                      _pushConstantBuffer->getHandle(), 0, size);
+    GLState->Buffer.bindUniformBufferRange(mapDescriptorSetPartLocation(GL3DescriptorSetPart::PushConstantSet_Uniforms),
+                                           static_cast<GL3BufferObject*>(range.buffer)->getHandle(),
+                                           range.offset,
+                                           range.size);
 }
 
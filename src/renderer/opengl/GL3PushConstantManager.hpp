@@ -1,20 +1,15 @@
 #pragma once
 
 #include "GL3Object.hpp"
-#include "GL3BufferObject.hpp"
-#include <renderer/BufferObject.hpp>
 
-#include <memory>
+#include <cstddef>
 
+// Push constants are allocated linearly from the uniform ring buffer of the renderer. Every call gets its own range
+// which is bound with glBindBufferRange so the data of earlier draws stays intact without orphaning a buffer.
 class GL3PushConstantManager : public GL3Object {
-    std::unique_ptr<GL3BufferObject> _pushConstantBuffer;
-    size_t _bufferSize;
-
-    void ensureBufferSize(size_t size);
  public:
     GL3PushConstantManager(GL3Renderer* renderer);
 
     void setConstants(void* data, size_t size);
 };
 
-
@@ -55,8 +55,10 @@ std::vector<TextureHandle*> GL3RenderTarget::getColorTextures() {
     return handles;
 }
 void GL3RenderTarget::setDepthTexture(std::unique_ptr<GL3Texture>&& handle) {
+    handle->markAsRenderTarget();
     _depthTexture = std::move(handle);
 }
 void GL3RenderTarget::addColorTexture(std::unique_ptr<GL3Texture>&& handle) {
+    handle->markAsRenderTarget();
     _colorTextures.push_back(std::move(handle));
 }
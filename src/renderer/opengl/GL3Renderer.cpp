@@ -6,6 +6,7 @@
 #include "EnumTranslation.hpp"
 #include "GL3ShaderDefintions.hpp"
 #include "GL3CommandBuffer.hpp"
+#include "GL3DeferredCommandBuffer.hpp"
 #include "renderer/Exceptions.hpp"
 #include "util/Assertion.hpp"
 #include "GL3PipelineState.hpp"
@@ -15,6 +16,7 @@
 #include <SDL.h>
 #include <SDL_video.h>
 
+#include <algorithm>
 #include <sstream>
 
 
@@ -135,11 +137,14 @@ bool printNextDebugMessage() {
 void glad_noop_callback(const char* name, void* funcptr, int len_args, ...) {
 }
 #endif
+
+// Expired entries are only removed once the pipeline cache grew to this size
+const size_t MIN_PIPELINE_CACHE_SWEEP_SIZE = 64;
 }
 
-GL3Renderer::GL3Renderer(std::unique_ptr<FileLoader>&& fileLoader) : _fileLoader(std::move(fileLoader)),
-                                                                     _settingsManager(this), _window(nullptr),
-                                                                     _initialized(false) {
+GL3Renderer::GL3Renderer(std::unique_ptr<FileLoader>&& fileLoader)
+    : _fileLoader(std::move(fileLoader)), _settingsManager(this), _window(nullptr), _initialized(false),
+      _pipelineCacheSweepSize(MIN_PIPELINE_CACHE_SWEEP_SIZE) {
 
 }
 
@@ -148,6 +153,11 @@ GL3Renderer::~GL3Renderer() {
 }
 
 void GL3Renderer::deinitialize() {
+    _commandBufferPool.reset();
+    _uploadQueue.reset();
+    _uniformRingBuffer.reset();
+    _descriptorSetPool.clear();
+    _pipelineCache.clear();
     _shaderManager.reset();
     _renderTargetManager.reset();
     _profiler.reset();
@@ -226,6 +236,9 @@ void GL3Renderer::initialize(SDL_Window* window) {
     _pushConstantManager.reset(new GL3PushConstantManager(this));
     _profiler.reset(new GL3Profiler(this));
     _debugging.reset(new GL3Debugging());
+    _commandBufferPool.reset(new CommandBufferPool(this));
+    _uploadQueue.reset(new UploadQueue());
+    _uniformRingBuffer.reset(new GL3UniformRingBuffer(this, 1024 * 1024));
 
     _shaderManager.reset(new GL3ShaderManager(_fileLoader.get()));
     // Preload the shaders
@@ -250,6 +263,12 @@ RendererSettingsManager* GL3Renderer::getSettingsManager() {
 }
 
 void GL3Renderer::presentNextFrame() {
+    // Done before the profiler so that the uploads are counted for this frame
+    _uploadQueue->process();
+
+    _profiler->frameFinished();
+    _uniformRingBuffer->frameFinished();
+
     SDL_GL_SwapWindow(_window);
 }
 
@@ -258,11 +277,48 @@ std::unique_ptr<BufferObject> GL3Renderer::createBuffer(BufferType type) {
         return nullptr;
     }
 
-    return std::unique_ptr<BufferObject>(new GL3BufferObject(type));
+    return std::unique_ptr<BufferObject>(new GL3BufferObject(this, type));
+}
+
+std::unique_ptr<CommandBuffer> GL3Renderer::createCommandBuffer(CommandBufferMode mode) {
+    switch (mode) {
+        case CommandBufferMode::Immediate:
+            // Only the render thread has a state tracker
+            Assertion(GLState, "Immediate command buffers can only be created on the render thread!");
+            return std::unique_ptr<CommandBuffer>(new GL3CommandBuffer(this));
+        case CommandBufferMode::Deferred:
+            return std::unique_ptr<CommandBuffer>(new GL3DeferredCommandBuffer(this));
+    }
+    return nullptr;
+}
+
+CommandBuffer* GL3Renderer::acquireCommandBuffer(CommandBufferMode mode) {
+    Assertion(mode == CommandBufferMode::Deferred || GLState,
+              "Immediate command buffers can only be acquired on the render thread!");
+
+    return _commandBufferPool->acquire(mode);
+}
+
+void GL3Renderer::releaseCommandBuffer(CommandBuffer* buffer) {
+    _commandBufferPool->release(buffer);
+}
+
+void GL3Renderer::submit(CommandBuffer* buffer) {
+    submit(&buffer, 1);
 }
 
-std::unique_ptr<CommandBuffer> GL3Renderer::createCommandBuffer() {
-    return std::unique_ptr<CommandBuffer>(new GL3CommandBuffer(this));
+void GL3Renderer::submit(CommandBuffer* const* buffers, size_t count) {
+    Assertion(GLState, "Command buffers can only be submitted on the render thread!");
+
+    GL3CommandBuffer executor(this);
+    for (size_t i = 0; i < count; ++i) {
+        if (buffers[i]->getMode() != CommandBufferMode::Deferred) {
+            // Immediate buffers have already been executed
+            continue;
+        }
+
+        static_cast<GL3DeferredCommandBuffer*>(buffers[i])->execute(&executor);
+    }
 }
 
 std::unique_ptr<Texture> GL3Renderer::createTexture() {
@@ -270,13 +326,58 @@ std::unique_ptr<Texture> GL3Renderer::createTexture() {
 }
 
 std::unique_ptr<PipelineState> GL3Renderer::createPipelineState(const PipelineProperties& props) {
-    return std::unique_ptr<PipelineState>(new GL3PipelineState(this, props));
+    auto iter = _pipelineCache.find(props);
+    if (iter != _pipelineCache.end()) {
+        auto object = iter->second.lock();
+        if (object) {
+            return std::unique_ptr<PipelineState>(new GL3PipelineState(object));
+        }
+
+        // All handles of this pipeline have been destroyed
+        _pipelineCache.erase(iter);
+    }
+
+    // Pipelines which are never created again leave expired entries behind. They are removed whenever the cache doubled
+    // in size since the last sweep so the cost is amortized over the insertions.
+    if (_pipelineCache.size() >= _pipelineCacheSweepSize) {
+        sweepPipelineCache();
+    }
+
+    std::shared_ptr<GL3PipelineStateObject> object(new GL3PipelineStateObject(this, props));
+    _pipelineCache.insert(std::make_pair(props, object));
+
+    return std::unique_ptr<PipelineState>(new GL3PipelineState(object));
+}
+
+void GL3Renderer::sweepPipelineCache() {
+    auto iter = _pipelineCache.begin();
+    while (iter != _pipelineCache.end()) {
+        if (iter->second.expired()) {
+            iter = _pipelineCache.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    _pipelineCacheSweepSize = std::max(MIN_PIPELINE_CACHE_SWEEP_SIZE, 2 * _pipelineCache.size());
 }
 
 std::unique_ptr<DescriptorSet> GL3Renderer::createDescriptorSet(DescriptorSetType type) {
     return std::unique_ptr<DescriptorSet>(new GL3DescriptorSet(convertDescriptorSetType(type)));
 }
 
+DescriptorSetHandle GL3Renderer::createDescriptorSetHandle(DescriptorSetType type) {
+    return _descriptorSetPool.create(convertDescriptorSetType(type));
+}
+
+DescriptorSet* GL3Renderer::getDescriptorSet(DescriptorSetHandle handle) {
+    return _descriptorSetPool.get(handle);
+}
+
+void GL3Renderer::destroyDescriptorSet(DescriptorSetHandle handle) {
+    _descriptorSetPool.destroy(handle);
+}
+
 GL3ShaderManager* GL3Renderer::getShaderManager() {
     return _shaderManager.get();
 }
@@ -289,6 +390,18 @@ GL3RenderTargetManager* GL3Renderer::getGLRenderTargetManager() {
     return _renderTargetManager.get();
 }
 
+UniformBufferRange GL3Renderer::uploadStreamingUniforms(const void* data, size_t size) {
+    return _uniformRingBuffer->upload(data, size);
+}
+
+StreamingUniformAllocation GL3Renderer::allocateStreamingUniforms(size_t size) {
+    return _uniformRingBuffer->allocate(size);
+}
+
+void GL3Renderer::commitStreamingUniforms(const UniformBufferRange& range) {
+    _uniformRingBuffer->commit(range);
+}
+
 bool GL3Renderer::hasCapability(GraphicsCapability capability) const {
     switch (capability) {
         case GraphicsCapability::PointSprites:
@@ -311,10 +424,16 @@ Profiler* GL3Renderer::getProfiler() {
 GL3PushConstantManager* GL3Renderer::getPushConstantManager() {
     return _pushConstantManager.get();
 }
+
+GL3UniformRingBuffer* GL3Renderer::getUniformRingBuffer() {
+    return _uniformRingBuffer.get();
+}
 RendererLimits GL3Renderer::getLimits() const {
     RendererLimits limits;
 
     limits.uniform_offset_alignment = (size_t) GLState->Constants.getUniformBufferAlignment();
+    // The uniform ring buffer waits for the GPU at the end of every frame
+    limits.frames_in_flight = GL3UniformRingBuffer::FRAMES_IN_FLIGHT;
 
     return limits;
 }
@@ -323,6 +442,15 @@ std::unique_ptr<VertexArrayObject> GL3Renderer::createVertexArrayObject(const Ve
     GL3VertexInputState inputState(input);
     return inputState.createArrayObject(props);
 }
+
+UploadQueue* GL3Renderer::getUploadQueue() {
+    return _uploadQueue.get();
+}
+
+MemoryTracker* GL3Renderer::getMemoryTracker() {
+    return &_memoryTracker;
+}
+
 Debugging* GL3Renderer::getDebugging() {
     return _debugging.get();
 }
@@ -6,9 +6,17 @@
 #include "GL3Profiler.hpp"
 #include "GL3PushConstantManager.hpp"
 #include "GL3Debugging.hpp"
+#include "GL3PipelineState.hpp"
+#include "GL3ShaderParameters.hpp"
+#include "GL3UniformRingBuffer.hpp"
+
+#include <renderer/CommandBufferPool.hpp>
+#include <renderer/UploadQueue.hpp>
 
 #include <SDL_video.h>
 
+#include <unordered_map>
+
 class GL3Renderer final: public Renderer {
  public:
     class GL3RenderSettingsManager: GL3Object, public RendererSettingsManager {
@@ -31,6 +39,8 @@ class GL3Renderer final: public Renderer {
     };
 
  private:
+    // Declared first so that it outlives all resources which are registered in it
+    MemoryTracker _memoryTracker;
 
     std::unique_ptr<FileLoader> _fileLoader;
 
@@ -45,6 +55,18 @@ class GL3Renderer final: public Renderer {
     std::unique_ptr<GL3Profiler> _profiler;
     std::unique_ptr<GL3PushConstantManager> _pushConstantManager;
     std::unique_ptr<GL3Debugging> _debugging;
+    std::unique_ptr<CommandBufferPool> _commandBufferPool;
+    std::unique_ptr<UploadQueue> _uploadQueue;
+    std::unique_ptr<GL3UniformRingBuffer> _uniformRingBuffer;
+
+    // Pipelines are only kept alive by the handles returned from createPipelineState
+    std::unordered_map<PipelineProperties, std::weak_ptr<GL3PipelineStateObject>> _pipelineCache;
+    size_t _pipelineCacheSweepSize;
+
+    HandlePool<GL3DescriptorSet, DescriptorSet> _descriptorSetPool;
+
+    // Removes the entries of pipelines whose handles have all been destroyed
+    void sweepPipelineCache();
  public:
     explicit GL3Renderer(std::unique_ptr<FileLoader>&& fileLoader);
 
@@ -62,9 +84,22 @@ class GL3Renderer final: public Renderer {
 
     virtual Debugging* getDebugging() override;
 
+    virtual UploadQueue* getUploadQueue() override;
+
+    virtual MemoryTracker* getMemoryTracker() override;
+
     virtual std::unique_ptr<BufferObject> createBuffer(BufferType type) override;
 
-    virtual std::unique_ptr<CommandBuffer> createCommandBuffer() override;
+    virtual std::unique_ptr<CommandBuffer> createCommandBuffer(
+        CommandBufferMode mode = CommandBufferMode::Immediate) override;
+
+    virtual CommandBuffer* acquireCommandBuffer(CommandBufferMode mode = CommandBufferMode::Immediate) override;
+
+    virtual void releaseCommandBuffer(CommandBuffer* buffer) override;
+
+    virtual void submit(CommandBuffer* buffer) override;
+
+    virtual void submit(CommandBuffer* const* buffers, size_t count) override;
 
     virtual std::unique_ptr<Texture> createTexture() override;
 
@@ -72,9 +107,21 @@ class GL3Renderer final: public Renderer {
 
     virtual std::unique_ptr<DescriptorSet> createDescriptorSet(DescriptorSetType type) override;
 
+    virtual DescriptorSetHandle createDescriptorSetHandle(DescriptorSetType type) override;
+
+    virtual DescriptorSet* getDescriptorSet(DescriptorSetHandle handle) override;
+
+    virtual void destroyDescriptorSet(DescriptorSetHandle handle) override;
+
     virtual std::unique_ptr<VertexArrayObject> createVertexArrayObject(const VertexInputStateProperties& input,
                                                                        const VertexArrayProperties& props) override;
 
+    virtual UniformBufferRange uploadStreamingUniforms(const void* data, size_t size) override;
+
+    virtual StreamingUniformAllocation allocateStreamingUniforms(size_t size) override;
+
+    virtual void commitStreamingUniforms(const UniformBufferRange& range) override;
+
     virtual bool hasCapability(GraphicsCapability capability) const override;
 
     virtual RendererLimits getLimits() const override;
@@ -88,6 +135,8 @@ class GL3Renderer final: public Renderer {
     GL3ShaderManager* getShaderManager();
 
     GL3PushConstantManager* getPushConstantManager();
+
+    GL3UniformRingBuffer* getUniformRingBuffer();
 };
 
 
@@ -6,8 +6,16 @@
 #include "EnumTranslation.hpp"
 #include "GL3State.hpp"
 
-GL3Descriptor::GL3Descriptor(GL3DescriptorSetPart part) : _active(false) {
+GL3Descriptor::GL3Descriptor() : GL3Descriptor(GL3DescriptorSetPart::PushConstantSet_Uniforms) {
+}
+
+GL3Descriptor::GL3Descriptor(GL3DescriptorSetPart part)
+    : _location(mapDescriptorSetPartLocation(part)), _active(false) {
+    _data.type = DescriptorType::Texture;
     _data.part = part;
+    _data.descriptor_data.buffer.buffer = nullptr;
+    _data.descriptor_data.buffer.offset = 0;
+    _data.descriptor_data.buffer.size = 0;
 }
 
 void GL3Descriptor::setTexture(TextureHandle* handle) {
@@ -48,14 +56,13 @@ void GL3Descriptor::setUniformBuffer(BufferObject* object, size_t offset, size_t
 void GL3Descriptor::bind() {
     switch (_data.type) {
         case DescriptorType::UniformBuffer:
-            glBindBufferRange(GL_UNIFORM_BUFFER,
-                              mapDescriptorSetPartLocation(_data.part),
-                              _data.descriptor_data.buffer.buffer->getHandle(),
-                              _data.descriptor_data.buffer.offset,
-                              _data.descriptor_data.buffer.size);
+            GLState->Buffer.bindUniformBufferRange(_location,
+                                                   _data.descriptor_data.buffer.buffer->getHandle(),
+                                                   _data.descriptor_data.buffer.offset,
+                                                   _data.descriptor_data.buffer.size);
             break;
         case DescriptorType::Texture:
-            _data.descriptor_data.texture.bind(mapDescriptorSetPartLocation(_data.part));
+            _data.descriptor_data.texture.bind(_location);
             break;
     }
 
@@ -68,41 +75,49 @@ void GL3Descriptor::unbind() {
             break;
         case DescriptorType::Texture:
             // Unbind this texture type
-            GLState->Texture.bindTexture(mapDescriptorSetPartLocation(_data.part), GL_TEXTURE_2D, 0);
+            GLState->Texture.bindTexture(_location, GL_TEXTURE_2D, 0);
             break;
     }
 
     _active = false;
 }
 
-GL3DescriptorSet::GL3DescriptorSet(Gl3DescriptorSetType type) : _type(type), _active(false) {
+GL3DescriptorSet::GL3DescriptorSet(Gl3DescriptorSetType type) : _type(type), _active(false), _usedParts(0) {
 }
 
 Descriptor* GL3DescriptorSet::getDescriptor(DescriptorSetPart part) {
     return getDescriptor(convertDescriptorSetPart(part));
 }
 GL3Descriptor* GL3DescriptorSet::getDescriptor(GL3DescriptorSetPart part) {
-    auto iter = _descriptors.find(part);
+    auto index = static_cast<size_t>(part);
+    Assertion(index < NUM_PARTS, "Invalid descriptor set part!");
 
-    if (iter != _descriptors.end()) {
-        return iter->second.get();
+    auto bit = uint32_t(1) << index;
+    if (!(_usedParts & bit)) {
+        _descriptors[index] = GL3Descriptor(part);
+        _usedParts |= bit;
     }
 
-    auto result = _descriptors.insert(std::make_pair(part, std::unique_ptr<GL3Descriptor>(new GL3Descriptor(part))));
-    return result.first->second.get();
+    return &_descriptors[index];
 }
 
 
 void GL3DescriptorSet::bind() {
-    for (auto& entry : _descriptors) {
-        entry.second->bind();
+    size_t index = 0;
+    for (auto parts = _usedParts; parts != 0; parts >>= 1, ++index) {
+        if (parts & 1) {
+            _descriptors[index].bind();
+        }
     }
 
     _active = true;
 }
 void GL3DescriptorSet::unbind() {
-    for (auto& entry : _descriptors) {
-        entry.second->unbind();
+    size_t index = 0;
+    for (auto parts = _usedParts; parts != 0; parts >>= 1, ++index) {
+        if (parts & 1) {
+            _descriptors[index].unbind();
+        }
     }
 
     _active = false;
@@ -12,6 +12,7 @@
 
 #include <util/HashUtil.hpp>
 
+#include <array>
 #include <vector>
 #include <cstring>
 #include <unordered_map>
@@ -36,8 +37,10 @@ public:
 
 private:
     Data _data;
+    GLuint _location;
     bool _active;
 public:
+    GL3Descriptor();
     explicit GL3Descriptor(GL3DescriptorSetPart part);
     virtual ~GL3Descriptor() {}
 
@@ -58,12 +61,18 @@ public:
 };
 
 class GL3DescriptorSet final: public DescriptorSet {
+    static constexpr size_t NUM_PARTS = num_enum_values<GL3DescriptorSetPart>();
+    static_assert(NUM_PARTS <= 32, "Used parts do not fit into the mask anymore!");
+
     Gl3DescriptorSetType _type;
     bool _active;
 
-    std::unordered_map<GL3DescriptorSetPart, std::unique_ptr<GL3Descriptor>> _descriptors;
+    // Indexed by the descriptor set part. Only the parts in the mask have been requested and need to be bound.
+    std::array<GL3Descriptor, NUM_PARTS> _descriptors;
+    uint32_t _usedParts;
 public:
-    explicit GL3DescriptorSet(Gl3DescriptorSetType type);
+    // The default constructor is only used for the empty slots of a HandlePool
+    explicit GL3DescriptorSet(Gl3DescriptorSetType type = Gl3DescriptorSetType::ViewSet);
     virtual ~GL3DescriptorSet() {}
 
     GL3Descriptor* getDescriptor(GL3DescriptorSetPart part);
@@ -1,6 +1,7 @@
 #include "GL3State.hpp"
 #include "EnumTranslation.hpp"
 
+
 namespace
 {
     void enableDisableState(GLenum state, bool value)
@@ -16,6 +17,13 @@ namespace
 }
 
 thread_local std::unique_ptr<GL3StateTracker> GLState;
+thread_local FrameStatistics GLFrameStatistics;
+
+GL3BufferState::GL3BufferState() {
+    GLint bindings;
+    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &bindings);
+    _uniformBufferRanges.resize(static_cast<size_t>(bindings));
+}
 
 void GL3BufferState::bindArrayBuffer(GLuint buffer) {
     if (_arrayBuffer.setIfChanged(buffer)) {
@@ -35,6 +43,33 @@ void GL3BufferState::bindUniformBuffer(GLuint buffer) {
     }
 }
 
+void GL3BufferState::bindUniformBufferRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    if (_uniformBufferRanges[index].setIfChanged(GL3UniformBufferRange(buffer, offset, size))) {
+        glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+
+        // This also changes the generic binding point
+        _uniformBuffer.set(buffer);
+    }
+}
+
+void GL3BufferState::bufferDeleted(GLuint buffer) {
+    if (*_arrayBuffer == buffer) {
+        _arrayBuffer.markDirty();
+    }
+    if (*_elementBuffer == buffer) {
+        _elementBuffer.markDirty();
+    }
+    if (*_uniformBuffer == buffer) {
+        _uniformBuffer.markDirty();
+    }
+
+    for (auto& range : _uniformBufferRanges) {
+        if ((*range).buffer == buffer) {
+            range.markDirty();
+        }
+    }
+}
+
 GL3TextureState::GL3TextureState() {
     GLint units;
     glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &units);
@@ -45,13 +80,17 @@ void GL3TextureState::bindTexture(int tex_unit, GLenum target, GLuint handle) {
     auto& texunit = _textureUnits[tex_unit];
 
     if (texunit.textureTarget.isNewValue(target) || texunit.boundTexture.isNewValue(handle)) {
-        texunit.textureTarget.setIfChanged(target);
-        texunit.boundTexture.setIfChanged(handle);
+        texunit.textureTarget.set(target);
+        texunit.boundTexture.set(handle);
 
         // Only set texture unit if it will actually change something
         setActiveUnit(tex_unit);
 
         glBindTexture(target, handle);
+        ++GLFrameStatistics.texture_binds;
+        ++GLFrameStatistics.state_changes;
+    } else {
+        ++GLFrameStatistics.skipped_state_changes;
     }
 }
 
@@ -73,28 +112,57 @@ void GL3TextureState::bindTexture(GLenum target, GLuint handle) {
     auto& texunit = _textureUnits[*_activeTextureUnit];
 
     if (texunit.textureTarget.isNewValue(target) || texunit.boundTexture.isNewValue(handle)) {
-        texunit.textureTarget.setIfChanged(target);
-        texunit.boundTexture.setIfChanged(handle);
+        texunit.textureTarget.set(target);
+        texunit.boundTexture.set(handle);
 
         glBindTexture(target, handle);
+        ++GLFrameStatistics.texture_binds;
+        ++GLFrameStatistics.state_changes;
+    } else {
+        ++GLFrameStatistics.skipped_state_changes;
     }
 }
 
 
+GL3StateBlock::GL3StateBlock()
+    : depth(0), blend(0), stencil{0, 0, 0, 0}, cullFace(0), colorMask(0), scissor(0) {
+}
+
+uint32_t GL3StateBlock::getChangedGroups(const GL3StateBlock& other) const {
+    uint32_t changed = 0;
+
+    changed |= ((depth ^ other.depth) != 0) << Depth;
+    changed |= ((blend ^ other.blend) != 0) << Blend;
+    changed |= (((stencil[0] ^ other.stencil[0]) | (stencil[1] ^ other.stencil[1]) | (stencil[2] ^ other.stencil[2])
+        | (stencil[3] ^ other.stencil[3])) != 0) << Stencil;
+    changed |= ((cullFace ^ other.cullFace) != 0) << CullFace;
+    changed |= ((colorMask ^ other.colorMask) != 0) << ColorMask;
+    changed |= ((scissor ^ other.scissor) != 0) << Scissor;
+
+    return changed;
+}
+
+GL3StateTracker::GL3StateTracker()
+    : _primitiveType(GL_NONE), _drawVertexArray(nullptr), _validStateGroups(0) {
+}
+
 void GL3StateTracker::setDepthTest(bool enable) {
     if (_depthTest.setIfChanged(enable)) {
+        invalidateStateGroup(GL3StateBlock::Depth);
         enableDisableState(GL_DEPTH_TEST, enable);
     }
 }
 
 void GL3StateTracker::setDepthMask(bool flag) {
     if (_depthMask.setIfChanged(flag)) {
+        invalidateStateGroup(GL3StateBlock::Depth);
         glDepthMask(flag ? GL_TRUE : GL_FALSE);
     }
 }
 
 void GL3StateTracker::setDepthFunc(ComparisionFunction mode) {
     if (_depthFunction.setIfChanged(mode)) {
+        invalidateStateGroup(GL3StateBlock::Depth);
         glDepthFunc(convertComparisionFunction(mode));
     }
 }
@@ -113,6 +181,7 @@ void GL3StateTracker::bindRenderBuffer(GLuint renderbuffer) {
 
 void GL3StateTracker::setBlendMode(bool enable) {
     if (_blendEnabled.setIfChanged(enable)) {
+        invalidateStateGroup(GL3StateBlock::Blend);
         enableDisableState(GL_BLEND, enable);
     }
 }
@@ -120,6 +189,7 @@ void GL3StateTracker::setBlendMode(bool enable) {
 
 void GL3StateTracker::setBlendFunc(BlendFunction mode) {
     if (_blendFunc.setIfChanged(mode)) {
+        invalidateStateGroup(GL3StateBlock::Blend);
         switch (mode) {
             case BlendFunction::None:
                 break;
@@ -143,6 +213,7 @@ void GL3StateTracker::setScissorTest(bool enable)
 {
     if (_scissorTest.setIfChanged(enable))
     {
+        invalidateStateGroup(GL3StateBlock::Scissor);
         enableDisableState(GL_SCISSOR_TEST, enable);
     }
 }
@@ -151,13 +222,99 @@ void GL3StateTracker::setColorMask(const glm::bvec4& mask)
 {
     if (_colorMask.setIfChanged(mask))
     {
+        invalidateStateGroup(GL3StateBlock::ColorMask);
         glColorMask(mask[0], mask[1], mask[2], mask[3]);
     }
 }
 
+void GL3StateTracker::applyStateGroup(const GL3StateBlock& block, GL3StateBlock::Group group) {
+    switch (group) {
+        case GL3StateBlock::Depth: {
+            auto test = (block.depth & 1) != 0;
+            setDepthTest(test);
+            if (test) {
+                setDepthFunc(static_cast<ComparisionFunction>((block.depth >> 8) & 0xFF));
+            }
+            setDepthMask(((block.depth >> 1) & 1) != 0);
+            break;
+        }
+        case GL3StateBlock::Blend:
+            setBlendMode((block.blend & 1) != 0);
+            setBlendFunc(static_cast<BlendFunction>((block.blend >> 8) & 0xFF));
+            break;
+        case GL3StateBlock::Stencil:
+            Stencil.setStencilTest((block.stencil[0] & 1) != 0);
+            Stencil.setStencilMask(static_cast<GLuint>(block.stencil[0] >> 32));
+            Stencil.setStencilFunc(std::make_tuple(static_cast<GLenum>((block.stencil[0] >> 16) & 0xFFFF),
+                                                   static_cast<uint32_t>(block.stencil[1] & 0xFFFFFFFF),
+                                                   static_cast<uint32_t>(block.stencil[1] >> 32)));
+            Stencil.setFrontStencilOp(std::make_tuple(static_cast<GLenum>(block.stencil[2] & 0xFFFF),
+                                                      static_cast<GLenum>((block.stencil[2] >> 16) & 0xFFFF),
+                                                      static_cast<GLenum>((block.stencil[2] >> 32) & 0xFFFF)));
+            Stencil.setBackStencilOp(std::make_tuple(static_cast<GLenum>(block.stencil[3] & 0xFFFF),
+                                                     static_cast<GLenum>((block.stencil[3] >> 16) & 0xFFFF),
+                                                     static_cast<GLenum>((block.stencil[3] >> 32) & 0xFFFF)));
+            break;
+        case GL3StateBlock::CullFace:
+            CullFace.setFaceCulling((block.cullFace & 1) != 0);
+            CullFace.setCulledFace(static_cast<GLenum>((block.cullFace >> 16) & 0xFFFF));
+            CullFace.setFrontFace(static_cast<GLenum>((block.cullFace >> 32) & 0xFFFF));
+            break;
+        case GL3StateBlock::ColorMask:
+            setColorMask(glm::bvec4((block.colorMask & 1) != 0,
+                                    (block.colorMask & 2) != 0,
+                                    (block.colorMask & 4) != 0,
+                                    (block.colorMask & 8) != 0));
+            break;
+        case GL3StateBlock::Scissor:
+            setScissorTest(block.scissor != 0);
+            break;
+        case GL3StateBlock::NUM_GROUPS:
+            break;
+    }
+}
+
+void GL3StateTracker::applyStateBlock(const GL3StateBlock& block) {
+    // Groups that were changed by someone else have to be applied even if the block says they are the same
+    auto changed = (block.getChangedGroups(_stateBlock) | ~_validStateGroups) & GL3StateBlock::ALL_GROUPS;
+    if (changed == 0) {
+        return;
+    }
+
+    for (uint32_t group = 0; group < GL3StateBlock::NUM_GROUPS; ++group) {
+        if (changed & (1 << group)) {
+            applyStateGroup(block, static_cast<GL3StateBlock::Group>(group));
+        }
+    }
+
+    _stateBlock = block;
+    _validStateGroups = GL3StateBlock::ALL_GROUPS;
+}
+
+void GL3StateTracker::invalidateStateGroup(GL3StateBlock::Group group) {
+    _validStateGroups &= ~(1 << group);
+}
+
+void GL3StateTracker::setPrimitiveType(GLenum type) {
+    _primitiveType = type;
+}
+
+GLenum GL3StateTracker::getPrimitiveType() const {
+    return _primitiveType;
+}
+
+void GL3StateTracker::setDrawVertexArray(GL3VertexArrayObject* vao) {
+    _drawVertexArray = vao;
+}
+
+GL3VertexArrayObject* GL3StateTracker::getDrawVertexArray() const {
+    return _drawVertexArray;
+}
+
 void GL3ProgramState::use(GLuint program) {
     if (_activeProgram.setIfChanged(program)) {
         glUseProgram(program);
+        ++GLFrameStatistics.program_switches;
     }
 }
 
@@ -170,22 +327,28 @@ GL3FramebufferState::GL3FramebufferState() {
 void GL3FramebufferState::bindRead(GLuint name) {
     if (_activeReadBuffer.setIfChanged(name)) {
         glBindFramebuffer(GL_READ_FRAMEBUFFER, name);
+        ++GLFrameStatistics.framebuffer_switches;
     }
 }
 
 void GL3FramebufferState::bindDraw(GLuint name) {
     if (_activeDrawBuffer.setIfChanged(name)) {
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, name);
+        ++GLFrameStatistics.framebuffer_switches;
     }
 }
 
 void GL3FramebufferState::bind(GLuint name) {
     // GL_FRAMEBUFFER is a shortcut for both GL_DRAW_FRAMEBUFFER and GL_READ_FRAMEBUFFER
     if (_activeDrawBuffer.isNewValue(name) || _activeReadBuffer.isNewValue(name)) {
-        _activeReadBuffer = name;
-        _activeDrawBuffer = name;
+        _activeReadBuffer.set(name);
+        _activeDrawBuffer.set(name);
 
         glBindFramebuffer(GL_FRAMEBUFFER, name);
+        ++GLFrameStatistics.framebuffer_switches;
+        ++GLFrameStatistics.state_changes;
+    } else {
+        ++GLFrameStatistics.skipped_state_changes;
     }
 }
 
@@ -6,6 +6,12 @@
 #include <vector>
 #include <stack>
 #include <renderer/PipelineState.hpp>
+#include <renderer/Profiler.hpp>
+
+class GL3VertexArrayObject;
+
+// The statistics of the frame that is currently being rendered. Only the render thread modifies these.
+extern thread_local FrameStatistics GLFrameStatistics;
 
 template<typename T>
 class SavedState {
@@ -23,11 +29,19 @@ public:
         if (_dirty || new_val != _saved) {
             _saved = new_val;
             _dirty = false;
+            ++GLFrameStatistics.state_changes;
             return true;
         }
+        ++GLFrameStatistics.skipped_state_changes;
         return false;
     }
 
+    // Stores the value without counting it. Used when the state was changed by a call that is counted elsewhere.
+    void set(saved_type new_val) {
+        _saved = new_val;
+        _dirty = false;
+    }
+
     bool isNewValue(saved_type newVal) {
         return _dirty || newVal != _saved;
     }
@@ -50,16 +64,40 @@ public:
     }
 };
 
+struct GL3UniformBufferRange {
+    GLuint buffer;
+    GLintptr offset;
+    GLsizeiptr size;
+
+    GL3UniformBufferRange() : buffer(0), offset(0), size(0) { }
+    GL3UniformBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr size)
+        : buffer(buffer), offset(offset), size(size) { }
+
+    bool operator!=(const GL3UniformBufferRange& other) const {
+        return buffer != other.buffer || offset != other.offset || size != other.size;
+    }
+};
+
 class GL3BufferState {
     SavedState<GLuint> _arrayBuffer;
     SavedState<GLuint> _elementBuffer;
     SavedState<GLuint> _uniformBuffer;
+
+    std::vector<SavedState<GL3UniformBufferRange>> _uniformBufferRanges;
 public:
+    GL3BufferState();
+
     void bindArrayBuffer(GLuint buffer);
 
     void bindElementBuffer(GLuint buffer);
 
     void bindUniformBuffer(GLuint buffer);
+
+    // Binds a range of a buffer to an indexed uniform buffer binding. Binding the same range again does nothing.
+    void bindUniformBufferRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // Deleting a buffer resets the bindings which use it so these must not be considered bound anymore
+    void bufferDeleted(GLuint buffer);
 };
 
 class GL3TextureState {
@@ -159,6 +197,34 @@ public:
     void setFrontFace(GLenum frontFace);
 };
 
+// The fixed function state of a pipeline packed into a few words. Every word belongs to exactly one state group so the
+// groups which differ between two blocks can be found by comparing the words.
+struct GL3StateBlock {
+    enum Group {
+        Depth = 0,
+        Blend,
+        Stencil,
+        CullFace,
+        ColorMask,
+        Scissor,
+
+        NUM_GROUPS
+    };
+    static const uint32_t ALL_GROUPS = (1 << NUM_GROUPS) - 1;
+
+    uint64_t depth; // test | mask << 1 | function << 8
+    uint64_t blend; // enable | function << 8
+    uint64_t stencil[4]; // enable | function << 16 | mask << 32, reference | function mask << 32, front ops, back ops
+    uint64_t cullFace; // enable | culled face << 16 | front face << 32
+    uint64_t colorMask; // One bit per component
+    uint64_t scissor;
+
+    GL3StateBlock();
+
+    // Returns a bit mask with one bit per Group which is set if that group is different in the other block
+    uint32_t getChangedGroups(const GL3StateBlock& other) const;
+};
+
 class GL3StateTracker {
     SavedState<bool> _depthTest;
     SavedState<bool> _depthMask;
@@ -173,6 +239,17 @@ class GL3StateTracker {
     SavedState<bool> _scissorTest;
 
     SavedState<glm::bvec4> _colorMask;
+
+    // These are not OpenGL state but they are needed for issuing draw calls. They are stored here so that deferred
+    // command buffers can use the pipeline and vertex array object of the commands executed before them
+    GLenum _primitiveType;
+    GL3VertexArrayObject* _drawVertexArray;
+
+    // The last applied state block and the groups of that block which still match the actual state
+    GL3StateBlock _stateBlock;
+    uint32_t _validStateGroups;
+
+    void applyStateGroup(const GL3StateBlock& block, GL3StateBlock::Group group);
 public:
     GL3BufferState Buffer;
     GL3TextureState Texture;
@@ -182,6 +259,8 @@ public:
     GL3Stencil Stencil;
     GL3CullFace CullFace;
 
+    GL3StateTracker();
+
     void setDepthTest(bool enable);
 
     void setDepthMask(bool flag);
@@ -199,6 +278,20 @@ public:
     void setScissorTest(bool enable);
 
     void setColorMask(const glm::bvec4& mask);
+
+    // Only applies the groups that differ from the last applied block. Code that changes the state of a group without
+    // a state block must call invalidateStateGroup. The setters of this class already do that.
+    void applyStateBlock(const GL3StateBlock& block);
+
+    void invalidateStateGroup(GL3StateBlock::Group group);
+
+    void setPrimitiveType(GLenum type);
+
+    GLenum getPrimitiveType() const;
+
+    void setDrawVertexArray(GL3VertexArrayObject* vao);
+
+    GL3VertexArrayObject* getDrawVertexArray() const;
 };
 
 extern thread_local std::unique_ptr<GL3StateTracker> GLState;
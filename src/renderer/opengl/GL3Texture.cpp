@@ -114,14 +114,16 @@ GL3Texture::GL3Texture(GL3Renderer* renderer)
     : GL3Object(renderer), GL3OwnedTextureHandle(GL_TEXTURE_2D, 0), _swizzles(gli::SWIZZLE_RED,
                                                                               gli::SWIZZLE_GREEN,
                                                                               gli::SWIZZLE_BLUE,
-                                                                              gli::SWIZZLE_ALPHA) {
+                                                                              gli::SWIZZLE_ALPHA),
+      _memory(renderer->getMemoryTracker(), MemoryCategory::Texture) {
 }
 
 GL3Texture::GL3Texture(GL3Renderer* renderer, GLuint handle)
     : GL3Object(renderer), GL3OwnedTextureHandle(GL_TEXTURE_2D, handle), _swizzles(gli::SWIZZLE_RED,
                                                                                    gli::SWIZZLE_GREEN,
                                                                                    gli::SWIZZLE_BLUE,
-                                                                                   gli::SWIZZLE_ALPHA) {
+                                                                                   gli::SWIZZLE_ALPHA),
+      _memory(renderer->getMemoryTracker(), MemoryCategory::Texture) {
 }
 
 GL3Texture::~GL3Texture() {
@@ -142,8 +144,18 @@ void GL3Texture::copyDataFromFramebuffer(GLsizei width, GLsizei height) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
     glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 0, 0, width, height, 0);
+
+    _memory.setTextureAllocation(_format,
+                                 gli::TARGET_2D,
+                                 1,
+                                 MemoryTracker::computeTextureSize(_format, gli::TARGET_2D, _extent, 1));
+    applyDebugName();
+
     GLState->Texture.bindTexture(0, GL_TEXTURE_2D, 0);
 }
+void GL3Texture::markAsRenderTarget() {
+    _memory.setCategory(MemoryCategory::RenderTarget);
+}
 std::unique_ptr<GL3Texture> GL3Texture::createTexture(GL3Renderer* renderer) {
     GLuint name;
     glGenTextures(1, &name);
@@ -214,6 +226,13 @@ void GL3Texture::allocate(const AllocationProperties& props) {
                               gli::SWIZZLE_BLUE,
                               gli::SWIZZLE_ALPHA);
     _extent = props.size;
+
+    _memory.setTextureAllocation(props.format,
+                                 props.target,
+                                 1,
+                                 MemoryTracker::computeTextureSize(props.format, props.target, props.size, 1));
+    applyDebugName();
+
     GLState->Texture.bindTexture(0, _target, 0);
 }
 void GL3Texture::setFilterProperties(const FilterProperties& props) const {
@@ -225,6 +244,17 @@ void GL3Texture::setFilterProperties(const FilterProperties& props) const {
     glTexParameterfv(_target, GL_TEXTURE_BORDER_COLOR, glm::value_ptr(props.border_color));
 }
 void GL3Texture::initialize(const gli::texture& texture, const FilterProperties& filterProperties) {
+    allocateLevels(texture, filterProperties);
+
+    for (std::size_t layer = 0; layer < texture.layers(); ++layer) {
+        for (std::size_t face = 0; face < texture.faces(); ++face) {
+            for (std::size_t level = 0; level < texture.levels(); ++level) {
+                uploadLevel(texture, layer, face, level);
+            }
+        }
+    }
+}
+void GL3Texture::allocateLevels(const gli::texture& texture, const FilterProperties& filterProperties) {
     gli::gl GL(gli::gl::PROFILE_GL33);
     gli::gl::format const format = GL.translate(texture.format(), texture.swizzles());
     GLenum target = GL.translate(texture.target());
@@ -241,7 +271,6 @@ void GL3Texture::initialize(const gli::texture& texture, const FilterProperties&
 
     setFilterProperties(filterProperties);
 
-    // First allocate store for all mipmap levels
     for (std::size_t level = 0; level < texture.levels(); ++level) {
         auto size = texture.extent(level);
 
@@ -282,79 +311,85 @@ void GL3Texture::initialize(const gli::texture& texture, const FilterProperties&
         }
     }
 
-    for (std::size_t Layer = 0; Layer < texture.layers(); ++Layer) {
-        for (std::size_t Face = 0; Face < texture.faces(); ++Face) {
-            for (std::size_t Level = 0; Level < texture.levels(); ++Level) {
-                GLsizei const LayerGL = static_cast<GLsizei>(Layer);
-                glm::tvec3<GLsizei> Extent(texture.extent(Level));
-                target = gli::is_target_cube(texture.target())
-                         ? static_cast<GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + Face)
-                         : target;
-
-                switch (texture.target()) {
-                    case gli::TARGET_1D:
-                        if (gli::is_compressed(texture.format()))
-                            glCompressedTexSubImage1D(
-                                target, static_cast<GLint>(Level), 0, Extent.x,
-                                format.Internal, static_cast<GLsizei>(texture.size(Level)),
-                                texture.data(Layer, Face, Level));
-                        else
-                            glTexSubImage1D(
-                                target, static_cast<GLint>(Level), 0, Extent.x,
-                                format.External, format.Type,
-                                texture.data(Layer, Face, Level));
-                        break;
-                    case gli::TARGET_1D_ARRAY:
-                    case gli::TARGET_2D:
-                    case gli::TARGET_CUBE:
-                        if (gli::is_compressed(texture.format()))
-                            glCompressedTexSubImage2D(
-                                target, static_cast<GLint>(Level),
-                                0, 0,
-                                Extent.x,
-                                texture.target() == gli::TARGET_1D_ARRAY ? LayerGL : Extent.y,
-                                format.Internal, static_cast<GLsizei>(texture.size(Level)),
-                                texture.data(Layer, Face, Level));
-                        else
-                            glTexSubImage2D(
-                                target, static_cast<GLint>(Level),
-                                0, 0,
-                                Extent.x,
-                                texture.target() == gli::TARGET_1D_ARRAY ? LayerGL : Extent.y,
-                                format.External, format.Type,
-                                texture.data(Layer, Face, Level));
-                        break;
-                    case gli::TARGET_2D_ARRAY:
-                    case gli::TARGET_3D:
-                    case gli::TARGET_CUBE_ARRAY:
-                        if (gli::is_compressed(texture.format()))
-                            glCompressedTexSubImage3D(
-                                target, static_cast<GLint>(Level),
-                                0, 0, 0,
-                                Extent.x, Extent.y,
-                                texture.target() == gli::TARGET_3D ? Extent.z : LayerGL,
-                                format.Internal, static_cast<GLsizei>(texture.size(Level)),
-                                texture.data(Layer, Face, Level));
-                        else
-                            glTexSubImage3D(
-                                target, static_cast<GLint>(Level),
-                                0, 0, 0,
-                                Extent.x, Extent.y,
-                                texture.target() == gli::TARGET_3D ? Extent.z : LayerGL,
-                                format.External, format.Type,
-                                texture.data(Layer, Face, Level));
-                        break;
-                    default:
-                        Assertion(false, "Unknown texture target encountered!");
-                        break;
-                }
-            }
-        }
-    }
-
     _extent = texture.extent(0);
     _format = texture.format();
     _swizzles = texture.swizzles();
+
+    _memory.setTextureAllocation(texture.format(), texture.target(), texture.levels(), texture.size());
+    applyDebugName();
+
+    GLState->Texture.bindTexture(0, _target, 0);
+}
+void GL3Texture::uploadLevel(const gli::texture& texture, size_t layer, size_t face, size_t level) {
+    Assertion(texture.format() == _format, "Levels can only be uploaded to storage allocated for the same texture!");
+
+    gli::gl GL(gli::gl::PROFILE_GL33);
+    gli::gl::format const format = GL.translate(texture.format(), texture.swizzles());
+
+    GLsizei const LayerGL = static_cast<GLsizei>(layer);
+    glm::tvec3<GLsizei> Extent(texture.extent(level));
+    GLenum target = gli::is_target_cube(texture.target())
+                    ? static_cast<GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face)
+                    : _target;
+
+    bind(0);
+    switch (texture.target()) {
+        case gli::TARGET_1D:
+            if (gli::is_compressed(texture.format()))
+                glCompressedTexSubImage1D(
+                    target, static_cast<GLint>(level), 0, Extent.x,
+                    format.Internal, static_cast<GLsizei>(texture.size(level)),
+                    texture.data(layer, face, level));
+            else
+                glTexSubImage1D(
+                    target, static_cast<GLint>(level), 0, Extent.x,
+                    format.External, format.Type,
+                    texture.data(layer, face, level));
+            break;
+        case gli::TARGET_1D_ARRAY:
+        case gli::TARGET_2D:
+        case gli::TARGET_CUBE:
+            if (gli::is_compressed(texture.format()))
+                glCompressedTexSubImage2D(
+                    target, static_cast<GLint>(level),
+                    0, 0,
+                    Extent.x,
+                    texture.target() == gli::TARGET_1D_ARRAY ? LayerGL : Extent.y,
+                    format.Internal, static_cast<GLsizei>(texture.size(level)),
+                    texture.data(layer, face, level));
+            else
+                glTexSubImage2D(
+                    target, static_cast<GLint>(level),
+                    0, 0,
+                    Extent.x,
+                    texture.target() == gli::TARGET_1D_ARRAY ? LayerGL : Extent.y,
+                    format.External, format.Type,
+                    texture.data(layer, face, level));
+            break;
+        case gli::TARGET_2D_ARRAY:
+        case gli::TARGET_3D:
+        case gli::TARGET_CUBE_ARRAY:
+            if (gli::is_compressed(texture.format()))
+                glCompressedTexSubImage3D(
+                    target, static_cast<GLint>(level),
+                    0, 0, 0,
+                    Extent.x, Extent.y,
+                    texture.target() == gli::TARGET_3D ? Extent.z : LayerGL,
+                    format.Internal, static_cast<GLsizei>(texture.size(level)),
+                    texture.data(layer, face, level));
+            else
+                glTexSubImage3D(
+                    target, static_cast<GLint>(level),
+                    0, 0, 0,
+                    Extent.x, Extent.y,
+                    texture.target() == gli::TARGET_3D ? Extent.z : LayerGL,
+                    format.External, format.Type,
+                    texture.data(layer, face, level));
+            break;
+        default:
+            Assertion(false, "Unknown texture target encountered!");
+            break;
+    }
     GLState->Texture.bindTexture(0, _target, 0);
 }
 void GL3Texture::update(const gli::extent3d& position,
@@ -401,5 +436,18 @@ void GL3Texture::update(const gli::extent3d& position,
 gli::extent3d GL3Texture::getSize() const {
     return _extent;
 }
+void GL3Texture::setDebugName(const std::string& name) {
+    _debugName = name;
+    _memory.setName(name);
+
+    applyDebugName();
+}
+void GL3Texture::applyDebugName() {
+    if (_debugName.empty() || !GLAD_GL_KHR_debug || !glIsTexture(_handle)) {
+        return;
+    }
+
+    glObjectLabelKHR(GL_TEXTURE, _handle, (GLsizei) _debugName.size(), _debugName.c_str());
+}
 
 
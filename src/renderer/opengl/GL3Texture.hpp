@@ -1,6 +1,7 @@
 #pragma once
 
 #include "renderer/Texture.hpp"
+#include "renderer/MemoryTracker.hpp"
 
 #include <glad/glad.h>
 #include "GL3Object.hpp"
@@ -48,7 +49,13 @@ class GL3Texture final: public GL3Object, public Texture, public GL3OwnedTexture
     gli::format _format;
     gli::swizzles _swizzles;
 
+    TrackedMemory _memory;
+    std::string _debugName;
+
     void setFilterProperties(const FilterProperties& props) const;
+
+    // Labels can only be attached once the texture object was bound
+    void applyDebugName();
  public:
     explicit GL3Texture(GL3Renderer* renderer);
     explicit GL3Texture(GL3Renderer* renderer, GLuint handle);
@@ -56,15 +63,24 @@ class GL3Texture final: public GL3Object, public Texture, public GL3OwnedTexture
 
     void copyDataFromFramebuffer(GLsizei width, GLsizei height);
 
+    // Moves the memory of this texture into the render target category of the memory statistics
+    void markAsRenderTarget();
+
     void allocate(const AllocationProperties& props) override;
 
     void initialize(const gli::texture& texture, const FilterProperties& filterProperties) override;
 
+    void allocateLevels(const gli::texture& texture, const FilterProperties& filterProperties) override;
+
+    void uploadLevel(const gli::texture& texture, size_t layer, size_t face, size_t level) override;
+
     void update(const gli::extent3d& position,
                 const gli::extent3d& size, const gli::format dataFormat, const void* data) override;
 
     virtual gli::extent3d getSize() const override;
 
+    void setDebugName(const std::string& name) override;
+
     static std::unique_ptr<GL3Texture> createTexture(GL3Renderer* renderer);
 };
 
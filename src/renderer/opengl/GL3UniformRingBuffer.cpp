@@ -0,0 +1,153 @@
+//
+//
+
+#include "GL3UniformRingBuffer.hpp"
+#include "GL3State.hpp"
+
+#include <util/Assertion.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+size_t alignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+bool isSignaled(GLsync fence) {
+    auto result = glClientWaitSync(fence, 0, 0);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+}
+
+GL3UniformRingBuffer::GL3UniformRingBuffer(GL3Renderer* renderer, size_t segmentSize)
+    : GL3Object(renderer), _bufferData(nullptr), _segmentSize(0), _currentSegment(0), _segmentOffset(0) {
+    _alignment = static_cast<size_t>(GLState->Constants.getUniformBufferAlignment());
+
+    for (auto& fence : _segmentFences) {
+        fence = nullptr;
+    }
+
+    allocateBuffer(alignUp(segmentSize, _alignment));
+}
+
+GL3UniformRingBuffer::~GL3UniformRingBuffer() {
+    for (auto& fence : _segmentFences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+    for (auto& retired : _retiredBuffers) {
+        if (retired.fence != nullptr) {
+            glDeleteSync(retired.fence);
+        }
+    }
+}
+
+void GL3UniformRingBuffer::allocateBuffer(size_t segmentSize) {
+    if (_buffer) {
+        // Ranges of this buffer may already have been handed out in this frame so it has to stay alive until the GPU
+        // is done with the frame. The fence is added once the frame is finished.
+        RetiredBuffer retired;
+        retired.buffer = std::move(_buffer);
+        retired.fence = nullptr;
+        _retiredBuffers.push_back(std::move(retired));
+    }
+
+    // The fences belong to the old buffer so they do not protect anything in the new one
+    for (auto& fence : _segmentFences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    _segmentSize = segmentSize;
+    _segmentOffset = 0;
+
+    _buffer.reset(new GL3BufferObject(_renderer, BufferType::Uniform));
+    _buffer->setDebugName("Uniform ring buffer");
+    _buffer->setData(nullptr, _segmentSize * FRAMES_IN_FLIGHT, BufferUsage::PersistentStreaming);
+    _bufferData = static_cast<uint8_t*>(_buffer->getPersistentPointer());
+}
+
+void GL3UniformRingBuffer::waitForFence(GLsync fence) {
+    if (isSignaled(fence)) {
+        return;
+    }
+
+    // The GPU is too far behind so we have to wait for it
+    while (true) {
+        auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        if (result != GL_TIMEOUT_EXPIRED) {
+            break;
+        }
+    }
+}
+
+void GL3UniformRingBuffer::releaseRetiredBuffers() {
+    _retiredBuffers.erase(std::remove_if(_retiredBuffers.begin(), _retiredBuffers.end(), [](RetiredBuffer& retired) {
+        if (retired.fence == nullptr || !isSignaled(retired.fence)) {
+            return false;
+        }
+
+        glDeleteSync(retired.fence);
+        return true;
+    }), _retiredBuffers.end());
+}
+
+UniformBufferRange GL3UniformRingBuffer::upload(const void* data, size_t size) {
+    auto allocation = allocate(size);
+
+    std::memcpy(allocation.data, data, size);
+    commit(allocation.range);
+
+    return allocation.range;
+}
+
+StreamingUniformAllocation GL3UniformRingBuffer::allocate(size_t size) {
+    Assertion(size > 0, "Size may not be zero!");
+
+    auto alignedSize = alignUp(size, _alignment);
+    if (_segmentOffset + alignedSize > _segmentSize) {
+        // Allocations of a frame need to be in a single segment. Grow the buffer so that this frame fits.
+        allocateBuffer(std::max(_segmentSize * 2, alignUp(_segmentOffset + alignedSize, _alignment)));
+    }
+
+    StreamingUniformAllocation allocation;
+    allocation.range.buffer = _buffer.get();
+    allocation.range.offset = _currentSegment * _segmentSize + _segmentOffset;
+    allocation.range.size = size;
+    allocation.data = _bufferData + allocation.range.offset;
+
+    _segmentOffset += alignedSize;
+
+    return allocation;
+}
+
+void GL3UniformRingBuffer::commit(const UniformBufferRange& range) {
+    // The range may belong to a buffer which was retired in this frame
+    static_cast<GL3BufferObject*>(range.buffer)->flushPersistentRange(range.offset, range.size);
+}
+
+void GL3UniformRingBuffer::frameFinished() {
+    for (auto& retired : _retiredBuffers) {
+        if (retired.fence == nullptr) {
+            retired.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+    releaseRetiredBuffers();
+
+    _segmentFences[_currentSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    _currentSegment = (_currentSegment + 1) % FRAMES_IN_FLIGHT;
+    _segmentOffset = 0;
+
+    auto& nextFence = _segmentFences[_currentSegment];
+    if (nextFence != nullptr) {
+        waitForFence(nextFence);
+
+        glDeleteSync(nextFence);
+        nextFence = nullptr;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "renderer/Renderer.hpp"
+#include "GL3Object.hpp"
+#include "GL3BufferObject.hpp"
+
+#include <glad/glad.h>
+
+#include <memory>
+#include <cstdint>
+#include <vector>
+
+// One large uniform buffer that is split into a segment per frame in flight. Every frame writes into its own segment
+// and a fence is placed at the end of the frame. Before a segment is reused its fence is checked which only blocks if
+// the GPU is more than FRAMES_IN_FLIGHT frames behind. Since the written range is never used by the GPU the data can be
+// written directly into the persistently mapped buffer.
+class GL3UniformRingBuffer final: public GL3Object {
+ public:
+    static const size_t FRAMES_IN_FLIGHT = 3;
+
+ private:
+    struct RetiredBuffer {
+        std::unique_ptr<GL3BufferObject> buffer;
+        GLsync fence;
+    };
+
+    std::unique_ptr<GL3BufferObject> _buffer;
+    uint8_t* _bufferData;
+    size_t _segmentSize;
+    size_t _alignment;
+
+    size_t _currentSegment;
+    size_t _segmentOffset;
+
+    GLsync _segmentFences[FRAMES_IN_FLIGHT];
+
+    // Buffers which were replaced by a larger buffer but may still be used by the GPU
+    std::vector<RetiredBuffer> _retiredBuffers;
+
+    void allocateBuffer(size_t segmentSize);
+
+    void waitForFence(GLsync fence);
+
+    void releaseRetiredBuffers();
+ public:
+    GL3UniformRingBuffer(GL3Renderer* renderer, size_t segmentSize);
+    ~GL3UniformRingBuffer();
+
+    UniformBufferRange upload(const void* data, size_t size);
+
+    StreamingUniformAllocation allocate(size_t size);
+
+    void commit(const UniformBufferRange& range);
+
+    // Fences the segment of the current frame and moves on to the next one
+    void frameFinished();
+};
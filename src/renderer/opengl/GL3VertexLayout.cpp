@@ -49,7 +49,12 @@ GL3VertexArrayObject::GL3VertexArrayObject(const VertexArrayProperties& props,
         boundBuffer->bind();
 
         glEnableVertexAttribArray(comp.attribute_location);
-        glVertexAttribPointer(comp.attribute_location, comp.size, comp.data_type, GL_FALSE, comp.stride, comp.offset);
+        glVertexAttribPointer(comp.attribute_location,
+                              comp.size,
+                              comp.data_type,
+                              comp.normalized,
+                              comp.stride,
+                              comp.offset);
         glVertexAttribDivisor(comp.attribute_location, comp.divisor);
     }
 
@@ -86,6 +91,7 @@ GL3VertexInputState::GL3VertexInputState(const VertexInputStateProperties& props
         comp.attribute_location =
             mapAttributeLocation(attribute.type); // Data type is also the bound attribute location
 
+        comp.normalized = GL_FALSE;
         switch (attribute.format) {
             case DataFormat::Vec4:
                 comp.data_type = GL_FLOAT;
@@ -103,6 +109,49 @@ GL3VertexInputState::GL3VertexInputState(const VertexInputStateProperties& props
                 comp.data_type = GL_FLOAT;
                 comp.size = 1;
                 break;
+            case DataFormat::HalfVec2:
+                comp.data_type = GL_HALF_FLOAT;
+                comp.size = 2;
+                break;
+            case DataFormat::HalfVec4:
+                comp.data_type = GL_HALF_FLOAT;
+                comp.size = 4;
+                break;
+            case DataFormat::UNorm8Vec4:
+                comp.data_type = GL_UNSIGNED_BYTE;
+                comp.size = 4;
+                comp.normalized = GL_TRUE;
+                break;
+            case DataFormat::SNorm8Vec4:
+                comp.data_type = GL_BYTE;
+                comp.size = 4;
+                comp.normalized = GL_TRUE;
+                break;
+            case DataFormat::UNorm16Vec2:
+                comp.data_type = GL_UNSIGNED_SHORT;
+                comp.size = 2;
+                comp.normalized = GL_TRUE;
+                break;
+            case DataFormat::UNorm16Vec4:
+                comp.data_type = GL_UNSIGNED_SHORT;
+                comp.size = 4;
+                comp.normalized = GL_TRUE;
+                break;
+            case DataFormat::SNorm16Vec2:
+                comp.data_type = GL_SHORT;
+                comp.size = 2;
+                comp.normalized = GL_TRUE;
+                break;
+            case DataFormat::SNorm16Vec4:
+                comp.data_type = GL_SHORT;
+                comp.size = 4;
+                comp.normalized = GL_TRUE;
+                break;
+            case DataFormat::SNorm10Vec3W2:
+                comp.data_type = GL_INT_2_10_10_10_REV;
+                comp.size = 4;
+                comp.normalized = GL_TRUE;
+                break;
         }
 
         comp.offset = reinterpret_cast<void*>(attribute.offset);
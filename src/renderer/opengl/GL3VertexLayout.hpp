@@ -13,6 +13,7 @@ struct Component {
     GLuint attribute_location;
     GLenum data_type;
     GLint size;
+    GLboolean normalized;
     GLsizei stride;
     GLuint divisor;
     void* offset;
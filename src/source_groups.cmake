@@ -6,8 +6,13 @@ set(file_root
 set(file_model
     model/AssimpModelConverter.cpp
     model/AssimpModelConverter.hpp
+    model/MeshOptimizer.cpp
+    model/MeshOptimizer.hpp
     model/Model.cpp
     model/Model.hpp
+    model/ModelCompression.cpp
+    model/ModelCompression.hpp
+    model/ModelFormat.hpp
     model/ModelLoader.cpp
     model/ModelLoader.hpp
     )
@@ -15,16 +20,26 @@ set(file_model
 set(file_renderer
     renderer/BufferObject.hpp
     renderer/CommandBuffer.hpp
+    renderer/CommandBufferPool.cpp
+    renderer/CommandBufferPool.hpp
     renderer/Debugging.hpp
     renderer/Enums.hpp
     renderer/Exceptions.hpp
+    renderer/GeometryHeap.cpp
+    renderer/GeometryHeap.hpp
+    renderer/MemoryTracker.cpp
+    renderer/MemoryTracker.hpp
     renderer/PipelineState.hpp
     renderer/Profiler.hpp
     renderer/Renderer.hpp
+    renderer/RenderQueue.cpp
+    renderer/RenderQueue.hpp
     renderer/RenderTarget.hpp
     renderer/RenderTargetManager.hpp
     renderer/ShaderParameters.hpp
     renderer/Texture.hpp
+    renderer/UploadQueue.cpp
+    renderer/UploadQueue.hpp
     renderer/Util.hpp
     renderer/VertexLayout.hpp
     )
@@ -39,6 +54,28 @@ set(file_renderer_nanovg
     renderer/nanovg/stb_truetype.h
     )
 
+set(file_renderer_null
+    renderer/null/NullBufferObject.cpp
+    renderer/null/NullBufferObject.hpp
+    renderer/null/NullCommandBuffer.cpp
+    renderer/null/NullCommandBuffer.hpp
+    renderer/null/NullDebugging.hpp
+    renderer/null/NullObject.hpp
+    renderer/null/NullPipelineState.hpp
+    renderer/null/NullProfiler.cpp
+    renderer/null/NullProfiler.hpp
+    renderer/null/NullRenderer.cpp
+    renderer/null/NullRenderer.hpp
+    renderer/null/NullRenderTargetManager.cpp
+    renderer/null/NullRenderTargetManager.hpp
+    renderer/null/NullShaderParameters.cpp
+    renderer/null/NullShaderParameters.hpp
+    renderer/null/NullStatistics.hpp
+    renderer/null/NullTexture.cpp
+    renderer/null/NullTexture.hpp
+    renderer/null/NullVertexArrayObject.hpp
+    )
+
 set(file_renderer_opengl
     renderer/opengl/Enums.hpp
     renderer/opengl/EnumTranslation.hpp
@@ -48,6 +85,8 @@ set(file_renderer_opengl
     renderer/opengl/GL3CommandBuffer.cpp
     renderer/opengl/GL3Debugging.hpp
     renderer/opengl/GL3Debugging.cpp
+    renderer/opengl/GL3DeferredCommandBuffer.cpp
+    renderer/opengl/GL3DeferredCommandBuffer.hpp
     renderer/opengl/GL3Object.cpp
     renderer/opengl/GL3Object.hpp
     renderer/opengl/GL3PipelineState.cpp
@@ -72,6 +111,8 @@ set(file_renderer_opengl
     renderer/opengl/GL3State.hpp
     renderer/opengl/GL3Texture.cpp
     renderer/opengl/GL3Texture.hpp
+    renderer/opengl/GL3UniformRingBuffer.cpp
+    renderer/opengl/GL3UniformRingBuffer.hpp
     renderer/opengl/GL3Util.cpp
     renderer/opengl/GL3Util.hpp
     renderer/opengl/GL3VertexLayout.cpp
@@ -99,16 +140,21 @@ set(file_util
     util/DefaultFileLoader.cpp
     util/EnumClassUtil.hpp
     util/FileLoader.hpp
+    util/FreeListAllocator.cpp
+    util/FreeListAllocator.hpp
+    util/HandlePool.hpp
     util/HashUtil.hpp
+    util/MemoryMappedFile.cpp
+    util/MemoryMappedFile.hpp
+    util/StreamingUniformAligner.hpp
     util/textures.hpp
     util/textures.cpp
     util/Timing.hpp
     util/Timing.cpp
-    util/UniformAligner.hpp
     util/UniqueHandle.hpp
     util/VariableStackArray.hpp
-    util/VariableUniformBuffer.cpp
-    util/VariableUniformBuffer.hpp
+    util/WorkerPool.cpp
+    util/WorkerPool.hpp
     util/stb_image.h
     )
 
@@ -117,6 +163,7 @@ source_group("" FILES ${file_root})
 source_group("Model" FILES ${file_model})
 source_group("Renderer" FILES ${file_renderer})
 source_group("Renderer\\nanovg" FILES ${file_renderer_nanovg})
+source_group("Renderer\\null" FILES ${file_renderer_null})
 source_group("Renderer\\opengl" FILES ${file_renderer_opengl})
 source_group("Test" FILES ${file_test})
 source_group("Util" FILES ${file_util})
@@ -127,6 +174,7 @@ set(file_root
     ${file_model}
     ${file_renderer}
     ${file_renderer_nanovg}
+    ${file_renderer_null}
     ${file_renderer_opengl}
     ${file_test}
     ${file_util}
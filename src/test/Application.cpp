@@ -8,6 +8,7 @@
 #include <glm/gtx/euler_angles.hpp>
 
 #include <numeric>
+#include <algorithm>
 #include <ctime>
 #include <model/AssimpModelConverter.hpp>
 #include <model/ModelLoader.hpp>
@@ -19,6 +20,13 @@
 using namespace glm;
 
 namespace {
+// Large enough for a few hundred small models per page
+const size_t MODEL_VERTEX_PAGE_SIZE = 16 * 1024 * 1024;
+const size_t MODEL_INDEX_PAGE_SIZE = 4 * 1024 * 1024;
+const ModelVertexFormat MODEL_VERTEX_FORMAT = ModelVertexFormat::Packed;
+// Reading models is mostly waiting for the disk so a single thread is enough
+const size_t LOADING_THREADS = 1;
+
 struct VertexData {
     glm::vec3 position;
     glm::vec2 tex_coord;
@@ -129,28 +137,86 @@ void drawTimes(NVGcontext* ctx, const std::deque<float>& vals, size_t maxVals, i
 
     nvgReset(ctx);
 }
+
+void drawFrameStatistics(NVGcontext* ctx,
+                         const FrameStatistics& stats,
+                         const MemoryTracker* memory,
+                         int x,
+                         int y,
+                         int width) {
+    const float LINE_HEIGHT = 18.f;
+
+    std::pair<const char*, uint64_t> lines[] = {
+        { "Draw calls", stats.draw_calls },
+        { "Pipeline binds", stats.pipeline_binds },
+        { "Descriptor set binds", stats.descriptor_set_binds },
+        { "Buffer uploads", stats.buffer_uploads },
+        { "Buffer upload KiB", stats.buffer_upload_bytes / 1024 },
+        { "Texture binds", stats.texture_binds },
+        { "Program switches", stats.program_switches },
+        { "Framebuffer switches", stats.framebuffer_switches },
+        { "State changes", stats.state_changes },
+        { "Skipped state changes", stats.skipped_state_changes },
+        { "Buffer memory KiB", memory->getCategoryUsage(MemoryCategory::Buffer).current_bytes / 1024 },
+        { "Texture memory KiB", memory->getCategoryUsage(MemoryCategory::Texture).current_bytes / 1024 },
+        { "Render target memory KiB", memory->getCategoryUsage(MemoryCategory::RenderTarget).current_bytes / 1024 },
+        { "Peak memory KiB", memory->getTotalUsage().peak_bytes / 1024 },
+    };
+    auto numLines = sizeof(lines) / sizeof(lines[0]);
+
+    nvgSave(ctx);
+    nvgReset(ctx);
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, x, y, width, numLines * LINE_HEIGHT + 10.f);
+    nvgFillColor(ctx, nvgRGBA(128, 128, 128, 128));
+    nvgFill(ctx);
+
+    nvgFontFace(ctx, "sans");
+    nvgFontSize(ctx, 15.f);
+    nvgFillColor(ctx, nvgRGBA(255, 255, 255, 255));
+
+    char str[64];
+    for (size_t i = 0; i < numLines; ++i) {
+        auto lineY = y + 5 + i * LINE_HEIGHT;
+
+        nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+        nvgText(ctx, x + 5, lineY, lines[i].first, nullptr);
+
+        sprintf(str, "%llu", (unsigned long long) lines[i].second);
+        nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
+        nvgText(ctx, x + width - 5, lineY, str, nullptr);
+    }
+
+    nvgRestore(ctx);
+}
 }
 
 Application::Application(Renderer* renderer, Timing* time, SDL_Window* window)
-    : _timing(time), _renderer(renderer), _window(window), _lightingManager(renderer) {
+    : _timing(time), _renderer(renderer), _window(window), _loadingPool(LOADING_THREADS),
+      _sceneQueue(RenderQueueSortMode::FrontToBack),
+      _lightingManager(renderer, &_workerPool) {
     auto freq = SDL_GetPerformanceFrequency();
     auto begin = SDL_GetPerformanceCounter();
     AssimpModelConverter converter;
+    converter.setVertexFormat(MODEL_VERTEX_FORMAT);
+    converter.setCompressChunks(true);
     converter.convertModel("resources/duck.dae", "duck", "resources/export");
     auto end = SDL_GetPerformanceCounter();
 
     printf("Converting: %fms\n", (end - begin) * 1000.0 / freq);
 
-    ModelLoader loader(_renderer);
-
-    begin = SDL_GetPerformanceCounter();
-    _model = std::move(loader.loadModel("resources/export/duck"));
-    end = SDL_GetPerformanceCounter();
+    _modelGeometry.reset(new GeometryHeap(_renderer,
+                                          Model::createVertexInputState(MODEL_VERTEX_FORMAT),
+                                          MODEL_VERTEX_PAGE_SIZE,
+                                          MODEL_INDEX_PAGE_SIZE));
 
-    printf("Loading: %fms\n", (end - begin) * 1000.0 / freq);
+    // The model is read in the background and appears once its GPU resources were created by render()
+    _modelLoader.reset(new ModelLoader(_renderer, &_loadingPool, _modelGeometry.get(), MODEL_VERTEX_FORMAT));
+    _modelLoad = _modelLoader->loadModelAsync("resources/export/duck");
 
     auto modelPipelineState = _lightingManager.getGeometryProperties();
-    modelPipelineState.vertexInput = _model->getVertexInputState();
+    modelPipelineState.vertexInput = _modelGeometry->getVertexInputState();
     modelPipelineState.primitive_type = PrimitiveType::Triangle;
     _modelPipelineState = _renderer->createPipelineState(modelPipelineState);
 
@@ -201,26 +267,22 @@ Application::Application(Renderer* renderer, Timing* time, SDL_Window* window)
     _sunLight = _lightingManager.addLight(lighting::LightType::Directional, true);
     _sunLight->setDirection(glm::vec3(10.f, 5.f, 0.f));
     _sunLight->setColor(glm::vec3(1.f));
-    _lightingManager.updateLightData();
 
 //    auto light = _renderer->getLightingManager()->addLight(LightType::Point, false);
 //    light->setPosition(glm::vec3(-3.f, 1.f, 0.f));
 //    light->setColor(glm::vec3(2.4f, 8.2f, 5.3f));
 
-    int width, height;
-    SDL_GL_GetDrawableSize(SDL_GL_GetCurrentWindow(), &width, &height);
+    // Query the size through the renderer so that this also works without a window
+    auto resolution = _renderer->getSettingsManager()->getCurrentSettings().resolution;
 
-    _viewUniforms.projection_matrix = glm::perspectiveFov(45.0f, (float) width, (float) height, 0.01f, 50000.0f);
+    _viewUniforms.projection_matrix =
+        glm::perspectiveFov(45.0f, (float) resolution.x, (float) resolution.y, 0.01f, 50000.0f);
 
     _wholeFrameCategory = _renderer->getProfiler()->createCategory("Whole frame");
     nvgCreateFont(_nvgCtx, "sans", "resources/Roboto-Regular.ttf");
 
-    _viewUniformBuffer = _renderer->createBuffer(BufferType::Uniform);
-    _viewUniformBuffer->setData(nullptr, sizeof(ViewUniformData), BufferUsage::Streaming);
-
+    // The uniform buffer is set every frame since the view uniforms are streamed
     _viewDescriptorSet = _renderer->createDescriptorSet(DescriptorSetType::ViewSet);
-    auto descriptor = _viewDescriptorSet->getDescriptor(DescriptorSetPart::ViewSet_Uniforms);
-    descriptor->setUniformBuffer(_viewUniformBuffer.get(), 0, sizeof(ViewUniformData));
 }
 
 Application::~Application() {
@@ -232,39 +294,61 @@ void Application::render(Renderer* renderer) {
     float camX = sin(_timing->getTotalTime()) * radius;
     float camZ = cos(_timing->getTotalTime()) * radius;
 
-    auto cmd = _renderer->createCommandBuffer();
+    auto cmd = _renderer->acquireCommandBuffer();
 
     _wholeFrameCategory->begin();
 
+    _modelLoader->processLoadedModels();
+    if (_modelLoad.isValid() && _modelLoad.isDone()) {
+        _model = _modelLoad.takeModel();
+        if (!_model) {
+            fprintf(stderr, "Failed to load model!\n");
+        }
+        _modelLoad = ModelLoadHandle();
+    }
+
+    if (_model) {
+        _model->prepareData(mat4());
+    }
+
+    _viewUniforms.view_matrix =
+        glm::lookAt(glm::vec3(camX, 3.0, camZ), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
+    _viewUniforms.view_projection_matrix = _viewUniforms.projection_matrix * _viewUniforms.view_matrix;
+
     cmd->clear(glm::vec4(0.f, 0.f, 0.f, 1.f), ClearTarget::Color | ClearTarget::Depth | ClearTarget::Stencil);
 
-    auto matrices = _sunLight->beginShadowPass(cmd.get(), _viewUniforms);
+    auto matrices = _sunLight->beginShadowPass(cmd, _viewUniforms);
     ViewUniformData shadowView;
     shadowView.projection_matrix = matrices.projection;
     shadowView.view_matrix = matrices.view;
     shadowView.view_projection_matrix = shadowView.projection_matrix * shadowView.view_matrix;
-    _viewUniformBuffer->updateData(&shadowView, 0, sizeof(shadowView), UpdateFlags::DiscardOldData);
+
+    // Both passes are queued up front so the queue only needs to be sorted once
+    _sceneQueue.clear();
+    // The model uses the shadow pipeline bound by the light in the shadow pass
+    enqueueScene(ScenePass_Shadow, nullptr, shadowView.view_matrix);
+    enqueueScene(ScenePass_Geometry, _modelPipelineState.get(), _viewUniforms.view_matrix);
+
+    setViewUniforms(shadowView);
 
     cmd->bindDescriptorSet(_viewDescriptorSet.get());
-    renderScene(cmd.get());
+    renderScene(cmd, ScenePass_Shadow);
 
-    _sunLight->endShadowPass(cmd.get());
+    _sunLight->endShadowPass(cmd);
 
-    _viewUniforms.view_matrix =
-        glm::lookAt(glm::vec3(camX, 3.0, camZ), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
-    _viewUniforms.view_projection_matrix = _viewUniforms.projection_matrix * _viewUniforms.view_matrix;
-    _viewUniformBuffer->updateData(&_viewUniforms, 0, sizeof(_viewUniforms), UpdateFlags::DiscardOldData);
+    setViewUniforms(_viewUniforms);
 
     cmd->bindDescriptorSet(_viewDescriptorSet.get());
-    _lightingManager.beginLightPass(cmd.get());
+    _lightingManager.beginLightPass(cmd);
 
-    cmd->bindPipeline(_modelPipelineState);
-    renderScene(cmd.get());
+    renderScene(cmd, ScenePass_Geometry);
 
-    _lightingManager.endLightPass(cmd.get());
+    _lightingManager.endLightPass(cmd);
 
     renderUI();
 
+    _renderer->releaseCommandBuffer(cmd);
+
     _wholeFrameCategory->end();
     renderer->presentNextFrame();
 
@@ -333,20 +417,41 @@ void Application::renderUI() {
     y += h + 20;
     drawTimes(_nvgCtx, _gpuTimes, 120, x, y, w, h, "GPU Time");
 
+    y += h + 20;
+    drawFrameStatistics(_nvgCtx,
+                        _renderer->getProfiler()->getFrameStatistics(),
+                        _renderer->getMemoryTracker(),
+                        x,
+                        y,
+                        w);
+
     nvgEndFrame(_nvgCtx);
 }
-void Application::renderScene(CommandBuffer* cmd) {
-    DEBUG_SCOPE(debug1, _renderer->getDebugging(), "Scene render");
+void Application::enqueueScene(uint32_t pass, PipelineState* modelPipeline, const glm::mat4& view) {
+    if (_model) {
+        _model->enqueue(_sceneQueue, pass, modelPipeline, view);
+    }
+
+    RenderQueueItem floorItem;
+    floorItem.pipeline = _floorPipelineState.get();
+    floorItem.descriptor_set = _floorModelDescriptorSet.get();
+    floorItem.vertex_array = _floorVertexArrayObject.get();
+    _floorDrawCall.fillItem(floorItem);
 
-    _model->prepareData(mat4());
+    // The floor lies at the origin
+    _sceneQueue.add(pass, floorItem, -view[3].z);
+}
+void Application::setViewUniforms(const ViewUniformData& view) {
+    auto uniforms = _renderer->uploadStreamingUniforms(&view, sizeof(view));
 
-    _model->render(cmd);
+    _viewDescriptorSet->getDescriptor(DescriptorSetPart::ViewSet_Uniforms)->setUniformBuffer(uniforms.buffer,
+                                                                                             uniforms.offset,
+                                                                                             uniforms.size);
+}
+void Application::renderScene(CommandBuffer* cmd, uint32_t pass) {
+    DEBUG_SCOPE(debug1, _renderer->getDebugging(), "Scene render");
 
-    cmd->bindDescriptorSet(_floorModelDescriptorSet.get());
-    cmd->bindVertexArrayObject(_floorVertexArrayObject);
-    cmd->bindPipeline(_floorPipelineState);
-    _floorDrawCall.draw(cmd);
-    cmd->unbindDescriptorSet(_floorModelDescriptorSet);
+    _sceneQueue.execute(cmd, pass);
 }
 
 void Application::handleEvent(SDL_Event* event) {
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <renderer/Renderer.hpp>
+#include <renderer/RenderQueue.hpp>
 #include <util/Timing.hpp>
+#include <util/WorkerPool.hpp>
 #include <model/Model.hpp>
+#include <model/ModelLoader.hpp>
 #include <SDL_events.h>
 
 #include <renderer/nanovg/nanovg.h>
@@ -12,6 +15,11 @@
 #include "LightingManager.hpp"
 #include "DrawCall.hpp"
 
+enum ScenePass {
+    ScenePass_Shadow = 0,
+    ScenePass_Geometry
+};
+
 struct Particle {
     glm::vec3 position;
     float radius;
@@ -22,9 +30,18 @@ class Application {
     Renderer *_renderer;
     SDL_Window* _window;
 
+    // Declared before everything that submits jobs to them so they are destroyed last. Loading assets may take a long
+    // time so it has its own pool, otherwise the jobs of a frame could wait behind it.
+    WorkerPool _workerPool;
+    WorkerPool _loadingPool;
+
     NVGcontext* _nvgCtx;
 
     std::unique_ptr<PipelineState> _modelPipelineState;
+    // Declared before the model since the model frees its geometry when it is destroyed
+    std::unique_ptr<GeometryHeap> _modelGeometry;
+    std::unique_ptr<ModelLoader> _modelLoader;
+    ModelLoadHandle _modelLoad;
     std::unique_ptr<Model> _model;
 
     std::unique_ptr<BufferObject> _floorVertexDataObject;
@@ -36,7 +53,8 @@ class Application {
     std::unique_ptr<DescriptorSet> _floorModelDescriptorSet;
     DrawCall _floorDrawCall;
 
-    std::unique_ptr<BufferObject> _viewUniformBuffer;
+    RenderQueue _sceneQueue;
+
     std::unique_ptr<DescriptorSet> _viewDescriptorSet;
 
     lighting::LightingManager _lightingManager;
@@ -56,7 +74,11 @@ class Application {
     std::deque<float> _gpuTimes;
     void renderUI();
 
-    void renderScene(CommandBuffer* cmd);
+    void enqueueScene(uint32_t pass, PipelineState* modelPipeline, const glm::mat4& view);
+
+    void renderScene(CommandBuffer* cmd, uint32_t pass);
+
+    void setViewUniforms(const ViewUniformData& view);
 public:
     Application(Renderer *renderer, Timing *timimg, SDL_Window* window);
 
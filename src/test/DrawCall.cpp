@@ -34,3 +34,10 @@ void DrawCall::draw(CommandBuffer* cmd, uint32_t instances) {
         cmd->draw(_count, instances, _offset, 0);
     }
 }
+void DrawCall::fillItem(RenderQueueItem& item, uint32_t instances) {
+    item.indexed = _indexed;
+    item.count = _count;
+    item.offset = _offset;
+    item.base_vertex = _baseVertex;
+    item.instances = instances;
+}
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <renderer/CommandBuffer.hpp>
+#include <renderer/RenderQueue.hpp>
 
 class DrawCall {
     bool _indexed;
@@ -21,6 +22,8 @@ class DrawCall {
     DrawCall& baseVertex(uint32_t base);
 
     void draw(CommandBuffer* cmd, uint32_t instances = 1);
+
+    void fillItem(RenderQueueItem& item, uint32_t instances = 1);
 };
 
 
@@ -7,10 +7,17 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+
 namespace {
-const uint32_t MAX_LIGHTS = 128;
-std::unique_ptr<Texture> createTexture(Renderer* renderer, uint32_t width, uint32_t height, gli::format format) {
+const size_t LIGHTS_PER_COMMAND_BUFFER = 32;
+std::unique_ptr<Texture> createTexture(Renderer* renderer,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       gli::format format,
+                                       const char* name) {
     auto texture = renderer->createTexture();
+    texture->setDebugName(name);
 
     AllocationProperties props;
     props.target = gli::TARGET_2D;
@@ -23,13 +30,17 @@ std::unique_ptr<Texture> createTexture(Renderer* renderer, uint32_t width, uint3
 }
 
 namespace lighting {
-LightingManager::LightingManager(Renderer* renderer)
-    : _renderer(renderer), _util(renderer), _alignedUniformData(renderer->getLimits().uniform_offset_alignment) {
-    _alignedUniformData.resize(MAX_LIGHTS);
-
-    _uniformBuffer = _renderer->createBuffer(BufferType::Uniform);
-    _uniformBuffer->setData(nullptr, _alignedUniformData.getSize(), BufferUsage::Dynamic);
+LightingManager::RecordingJob::RecordingJob(LightingManager* manager)
+    : _manager(manager), begin(0), end(0), buffer(nullptr) {
+}
+void LightingManager::RecordingJob::execute() {
+    buffer = _manager->_renderer->acquireCommandBuffer(CommandBufferMode::Deferred);
+    _manager->recordLights(buffer, begin, end);
+}
 
+LightingManager::LightingManager(Renderer* renderer, WorkerPool* workerPool)
+    : _renderer(renderer), _workerPool(workerPool), _util(renderer),
+      _alignedUniformData(renderer, renderer->getLimits().uniform_offset_alignment), _numRecordingJobs(0) {
     _lightingDescriptorSet = _renderer->createDescriptorSet(DescriptorSetType::LightingSet);
 
     auto current = _renderer->getRenderTargetManager()->getCurrentRenderTarget();
@@ -80,10 +91,42 @@ void LightingManager::beginLightPass(CommandBuffer* cmd) {
 
     ensureRenderTargetSize(current->getWidth(), current->getHeight());
 
+    // The light uniforms are streaming data so they need to be uploaded every frame
+    updateLightData();
+
     _renderer->getRenderTargetManager()->pushRenderTargetBinding();
     _renderer->getRenderTargetManager()->useRenderTarget(_lightingRenderTarget.get());
 
     cmd->clear(glm::vec4(0.f, 0.f, 0.f, 1.f), ClearTarget::Color | ClearTarget::Depth);
+
+    _numRecordingJobs = 0;
+    for (size_t begin = 0; begin < _lights.size(); begin += LIGHTS_PER_COMMAND_BUFFER) {
+        if (_numRecordingJobs == _recordingJobs.size()) {
+            _recordingJobs.emplace_back(new RecordingJob(this));
+        }
+
+        auto& job = _recordingJobs[_numRecordingJobs++];
+        job->begin = begin;
+        job->end = std::min(begin + LIGHTS_PER_COMMAND_BUFFER, _lights.size());
+
+        _workerPool->submit(job.get(), &_recordingGroup);
+    }
+}
+LightingManager::~LightingManager() {
+    // The recording jobs reference this object
+    _recordingGroup.wait();
+}
+void LightingManager::recordLights(CommandBuffer* cmd, size_t begin, size_t end) {
+    for (auto i = begin; i < end; ++i) {
+        auto& light = _lights[i];
+
+        light->bindDescriptorSet(cmd);
+        if (light->getType() == LightType::Point) {
+            _sphereMesh->draw(cmd, 1);
+        } else {
+            _fullscreenTriMesh->draw(cmd, 1);
+        }
+    }
 }
 void LightingManager::endLightPass(CommandBuffer* cmd) {
     _renderer->getRenderTargetManager()->popRenderTargetBinding();
@@ -96,14 +139,18 @@ void LightingManager::endLightPass(CommandBuffer* cmd) {
     {
         DEBUG_SCOPE(lights, _renderer->getDebugging(), "Render lights");
 
-        for (auto& light : _lights) {
-            light->bindDescriptorSet(cmd);
-            if (light->getType() == LightType::Point) {
-                _sphereMesh->draw(cmd, 1);
-            } else {
-                _fullscreenTriMesh->draw(cmd, 1);
-            }
+        _recordingGroup.wait();
+        for (size_t i = 0; i < _numRecordingJobs; ++i) {
+            _lightBuffers.push_back(_recordingJobs[i]->buffer);
+        }
+        _numRecordingJobs = 0;
+
+        _renderer->submit(_lightBuffers.data(), _lightBuffers.size());
+
+        for (auto buffer : _lightBuffers) {
+            _renderer->releaseCommandBuffer(buffer);
         }
+        _lightBuffers.clear();
     }
 
     cmd->unbindDescriptorSet(_lightingDescriptorSet);
@@ -120,11 +167,23 @@ void LightingManager::ensureRenderTargetSize(size_t width, size_t height) {
     RenderTargetProperties props;
     props.width = width;
     props.height = height;
-    props.color_buffers.push_back(std::move(createTexture(_renderer, width, height, gli::FORMAT_RGB16_SFLOAT_PACK16)));
-    props.color_buffers.push_back(std::move(createTexture(_renderer, width, height, gli::FORMAT_RGB16_SFLOAT_PACK16)));
-    props.color_buffers.push_back(std::move(createTexture(_renderer, width, height, gli::FORMAT_RGBA8_UNORM_PACK8)));
-
-    props.depth_texture = createTexture(_renderer, width, height, gli::FORMAT_D24_UNORM_PACK32);
+    props.color_buffers.push_back(createTexture(_renderer,
+                                                width,
+                                                height,
+                                                gli::FORMAT_RGB16_SFLOAT_PACK16,
+                                                "G-Buffer position"));
+    props.color_buffers.push_back(createTexture(_renderer,
+                                                width,
+                                                height,
+                                                gli::FORMAT_RGB16_SFLOAT_PACK16,
+                                                "G-Buffer normal"));
+    props.color_buffers.push_back(createTexture(_renderer,
+                                                width,
+                                                height,
+                                                gli::FORMAT_RGBA8_UNORM_PACK8,
+                                                "G-Buffer albedo"));
+
+    props.depth_texture = createTexture(_renderer, width, height, gli::FORMAT_D24_UNORM_PACK32, "G-Buffer depth");
 
     _lightingRenderTarget = _renderer->getRenderTargetManager()->createRenderTarget(std::move(props));
 
@@ -146,19 +205,29 @@ void LightingManager::updateLightData() {
 
     auto frag_coord_scale = inverse_window_size * uv_scale;
 
+    if (_lights.empty()) {
+        return;
+    }
+
+    _alignedUniformData.reset();
+    _alignedUniformData.resize(_lights.size());
+
     size_t i = 0;
     for (auto& light : _lights) {
         LightParameters* params = _alignedUniformData.getElement(i);
         params->frag_coord_scale = frag_coord_scale;
         light->setParameters(params);
-        light->updateDescriptor(_uniformBuffer.get(), _alignedUniformData.getOffset(i), sizeof(LightParameters));
         ++i;
     }
 
-    _uniformBuffer->updateData(_alignedUniformData.getData(),
-                               0,
-                               _alignedUniformData.getSize(),
-                               UpdateFlags::DiscardOldData);
+    _alignedUniformData.finish();
+
+    i = 0;
+    for (auto& light : _lights) {
+        auto range = _alignedUniformData.getElementRange(i);
+        light->updateDescriptor(range.buffer, range.offset, range.size);
+        ++i;
+    }
 }
 
 PipelineProperties LightingManager::getGeometryProperties() const {
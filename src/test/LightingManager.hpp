@@ -1,13 +1,28 @@
 #pragma once
 
 #include <renderer/Renderer.hpp>
-#include <util/UniformAligner.hpp>
+#include <util/StreamingUniformAligner.hpp>
+#include <util/WorkerPool.hpp>
 #include "DrawUtil.hpp"
 #include "Light.hpp"
 
 namespace lighting {
 class LightingManager {
+    // Records the draws of a range of lights into a command buffer of the renderer
+    class RecordingJob final: public WorkerPool::Job {
+        LightingManager* _manager;
+     public:
+        size_t begin;
+        size_t end;
+        CommandBuffer* buffer;
+
+        explicit RecordingJob(LightingManager* manager);
+
+        void execute() override;
+    };
+
     Renderer* _renderer;
+    WorkerPool* _workerPool;
 
     DrawUtil _util;
 
@@ -16,9 +31,7 @@ class LightingManager {
 
     std::unique_ptr<RenderTarget> _lightingRenderTarget;
 
-    std::unique_ptr<BufferObject> _uniformBuffer;
-
-    UniformAligner<LightParameters> _alignedUniformData;
+    StreamingUniformAligner<LightParameters> _alignedUniformData;
 
     std::unique_ptr<DescriptorSet> _lightingDescriptorSet;
 
@@ -26,10 +39,20 @@ class LightingManager {
 
     std::vector<std::unique_ptr<Light>> _lights;
 
+    // Light draws are recorded on worker threads while the geometry pass is running. The jobs are kept between frames
+    // so recording does not allocate once there are enough jobs for all lights.
+    std::vector<std::unique_ptr<RecordingJob>> _recordingJobs;
+    size_t _numRecordingJobs;
+    WorkerPool::JobGroup _recordingGroup;
+    std::vector<CommandBuffer*> _lightBuffers;
+
     void ensureRenderTargetSize(size_t width, size_t height);
+
+    void recordLights(CommandBuffer* cmd, size_t begin, size_t end);
  public:
-    explicit LightingManager(Renderer* renderer);
-    ~LightingManager() { };
+    // The light draws are recorded on the threads of the worker pool
+    LightingManager(Renderer* renderer, WorkerPool* workerPool);
+    ~LightingManager();
 
     Light* addLight(LightType type, bool shadowing);
 
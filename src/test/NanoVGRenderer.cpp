@@ -4,8 +4,11 @@
 #include <gli/generate_mipmaps.hpp>
 
 #include <math.h>
+#include <algorithm>
 
 namespace {
+const size_t INITIAL_VERTEX_SEGMENT_CAPACITY = 4096;
+
 int nvgRenderCreate(void* userptr) {
     auto renderer = static_cast<NanoVGRenderer*>(userptr);
 
@@ -181,46 +184,36 @@ void deleteNanoVGContext(NVGcontext* context) {
 }
 
 NanoVGRenderer::NanoVGRenderer(Renderer* renderer)
-    : _renderer(renderer), _uniformAligner(renderer->getLimits().uniform_offset_alignment), _lastImageId(0) {
+    : _renderer(renderer), _framesInFlight(renderer->getLimits().frames_in_flight), _vertexSegmentCapacity(0),
+      _currentVertexSegment(0), _vertexBase(0),
+      _uniformAligner(renderer, renderer->getLimits().uniform_offset_alignment), _usedLocalDescriptorSets(0),
+      _lastImageId(0) {
 }
 
 void NanoVGRenderer::initialize() {
-    _vertexBuffer = _renderer->createBuffer(BufferType::Vertex);
-
-    VertexInputStateProperties vertexInput;
-    vertexInput.addComponent(AttributeType::Position2D,
+    _vertexInput.addComponent(AttributeType::Position2D,
                                    0,
                                    DataFormat::Vec2,
                                    offsetof(NVGvertex, x));
-    vertexInput.addComponent(AttributeType::TexCoord,
+    _vertexInput.addComponent(AttributeType::TexCoord,
                                    0,
                                    DataFormat::Vec2,
                                    offsetof(NVGvertex, u));
-    vertexInput.addBufferBinding(0, false, sizeof(NVGvertex));
-
-    VertexArrayProperties arrayProps;
-    arrayProps.addBufferBinding(0, _vertexBuffer.get());
-
-    _vertexArrayObject = _renderer->createVertexArrayObject(vertexInput, arrayProps);
+    _vertexInput.addBufferBinding(0, false, sizeof(NVGvertex));
 
-    _uniformBuffer = VariableUniformBuffer::createVariableBuffer(_renderer);
+    allocateVertexBuffer(INITIAL_VERTEX_SEGMENT_CAPACITY);
 
+    // The uniform buffer of this set is updated when the uniforms are uploaded
     _globalDescriptorSet = _renderer->createDescriptorSet(DescriptorSetType::NanoVGGlobalSet);
-    _globalDescriptorSet->getDescriptor(DescriptorSetPart::NanoVGGlobalSet_Uniforms)->setUniformBuffer(_uniformBuffer->buffer(),
-                                                                                                       0,
-                                                                                                       sizeof(GlobalUniformData));
-
-    // Initialize the global data
-    _uniformAligner.getHeader<GlobalUniformData>()->viewSize = glm::vec2(0.f, 0.f);
 
     // Now create all the pipeline states that we are going to need
     {
         auto props = getDefaultPipelineProperties();
 
         // Pipeline state for simple triangle draws
-        _trianglesPipelineState = createPipelineState(props, vertexInput, PrimitiveType::Triangle);
-        _triangleFillPipelineState = createPipelineState(props, vertexInput, PrimitiveType::TriangleFan);
-        _triangleStrokePipelineState = createPipelineState(props, vertexInput, PrimitiveType::TriangleStrip);
+        _trianglesPipelineState = createPipelineState(props, _vertexInput, PrimitiveType::Triangle);
+        _triangleFillPipelineState = createPipelineState(props, _vertexInput, PrimitiveType::TriangleFan);
+        _triangleStrokePipelineState = createPipelineState(props, _vertexInput, PrimitiveType::TriangleStrip);
     }
     {
         // Pipeline states for the fill shader
@@ -237,19 +230,19 @@ void NanoVGRenderer::initialize() {
 
         props.enableFaceCulling = false;
 
-        _fillShapePipelineState = createPipelineState(props, vertexInput, PrimitiveType::TriangleFan);
+        _fillShapePipelineState = createPipelineState(props, _vertexInput, PrimitiveType::TriangleFan);
 
         props.enableFaceCulling = true;
         props.colorMask = glm::bvec4(true, true, true, true);
         props.stencilFunc = std::make_tuple(ComparisionFunction::Equal, 0x00, 0xFF);
         props.setStencilOp(std::make_tuple(StencilOperation::Keep, StencilOperation::Keep, StencilOperation::Keep));
 
-        _fillAntiAliasPipelineState = createPipelineState(props, vertexInput, PrimitiveType::TriangleStrip);
+        _fillAntiAliasPipelineState = createPipelineState(props, _vertexInput, PrimitiveType::TriangleStrip);
 
         props.stencilFunc = std::make_tuple(ComparisionFunction::NotEqual, 0x00, 0xFF);
         props.setStencilOp(std::make_tuple(StencilOperation::Zero, StencilOperation::Zero, StencilOperation::Zero));
 
-        _fillFillPipelineState = createPipelineState(props, vertexInput, PrimitiveType::Triangle);
+        _fillFillPipelineState = createPipelineState(props, _vertexInput, PrimitiveType::Triangle);
     }
     {
         // Pipeline states for the stroke shader
@@ -260,15 +253,15 @@ void NanoVGRenderer::initialize() {
         props.setStencilOp(std::make_tuple(StencilOperation::Keep,
                                            StencilOperation::Keep,
                                            StencilOperation::Increment));
-        _strokeFillPipelineState = createPipelineState(props, vertexInput, PrimitiveType::TriangleStrip);
+        _strokeFillPipelineState = createPipelineState(props, _vertexInput, PrimitiveType::TriangleStrip);
 
         props.setStencilOp(std::make_tuple(StencilOperation::Keep, StencilOperation::Keep, StencilOperation::Keep));
-        _strokeAntiaiasPipelineState = createPipelineState(props, vertexInput, PrimitiveType::TriangleStrip);
+        _strokeAntiaiasPipelineState = createPipelineState(props, _vertexInput, PrimitiveType::TriangleStrip);
 
         props.colorMask = glm::bvec4(false, false, false, false);
         props.stencilFunc = std::make_tuple(ComparisionFunction::Always, 0x00, 0xFF);
         props.setStencilOp(std::make_tuple(StencilOperation::Zero, StencilOperation::Zero, StencilOperation::Zero));
-        _strokeClearStencilPipelineState = createPipelineState(props, vertexInput, PrimitiveType::TriangleStrip);
+        _strokeClearStencilPipelineState = createPipelineState(props, _vertexInput, PrimitiveType::TriangleStrip);
     }
 }
 
@@ -408,13 +401,17 @@ void NanoVGRenderer::renderFlush() {
 
     DEBUG_SCOPE(nvg_scope, _renderer->getDebugging(), "NanoVG flush");
 
-    auto cmd = _renderer->createCommandBuffer();
+    auto cmd = _renderer->acquireCommandBuffer();
 
     // First update changed data
     _uniformAligner.getHeader<GlobalUniformData>()->viewSize = _viewport;
 
-    _uniformBuffer->setData(_uniformAligner.getData(), _uniformAligner.getSize());
-    _vertexBuffer->setData(_vertices.data(), sizeof(NVGvertex) * _vertices.size(), BufferUsage::Streaming);
+    _uniformAligner.finish();
+
+    auto globalUniforms = _uniformAligner.getHeaderRange();
+    auto globalDescriptor = _globalDescriptorSet->getDescriptor(DescriptorSetPart::NanoVGGlobalSet_Uniforms);
+    globalDescriptor->setUniformBuffer(globalUniforms.buffer, globalUniforms.offset, globalUniforms.size);
+    uploadVertices();
 
     cmd->bindVertexArrayObject(_vertexArrayObject.get());
     cmd->bindDescriptorSet(_globalDescriptorSet.get());
@@ -422,29 +419,65 @@ void NanoVGRenderer::renderFlush() {
     for (auto& drawCall : _drawCalls) {
         switch (drawCall.type) {
             case CallType::Fill:
-                drawFill(cmd.get(), drawCall);
+                drawFill(cmd, drawCall);
                 break;
             case CallType::ConvexFill:
-                drawConvexFill(cmd.get(), drawCall);
+                drawConvexFill(cmd, drawCall);
                 break;
             case CallType::Stroke:
-                drawStroke(cmd.get(), drawCall);
+                drawStroke(cmd, drawCall);
                 break;
             case CallType::Triangles:
-                drawTriangles(cmd.get(), drawCall);
+                drawTriangles(cmd, drawCall);
                 break;
         }
     }
 
+    _renderer->releaseCommandBuffer(cmd);
+
     // Reset all data again
     renderCancel();
 }
+void NanoVGRenderer::allocateVertexBuffer(size_t segmentCapacity) {
+    _vertexSegmentCapacity = segmentCapacity;
+    _currentVertexSegment = 0;
+
+    // The storage of a persistent buffer is fixed so growing it needs a new buffer which also means that the vertex
+    // array object has to be created again.
+    _vertexBuffer = _renderer->createBuffer(BufferType::Vertex);
+    _vertexBuffer->setData(nullptr,
+                           sizeof(NVGvertex) * _vertexSegmentCapacity * _framesInFlight,
+                           BufferUsage::PersistentStreaming);
+
+    VertexArrayProperties arrayProps;
+    arrayProps.addBufferBinding(0, _vertexBuffer.get());
+
+    _vertexArrayObject = _renderer->createVertexArrayObject(_vertexInput, arrayProps);
+}
+void NanoVGRenderer::uploadVertices() {
+    if (_vertices.size() > _vertexSegmentCapacity) {
+        allocateVertexBuffer(std::max(_vertexSegmentCapacity * 2, _vertices.size()));
+    } else {
+        _currentVertexSegment = (_currentVertexSegment + 1) % _framesInFlight;
+    }
+    _vertexBase = _currentVertexSegment * _vertexSegmentCapacity;
+
+    if (_vertices.empty()) {
+        return;
+    }
+
+    auto dest = static_cast<NVGvertex*>(_vertexBuffer->getPersistentPointer()) + _vertexBase;
+    memcpy(dest, _vertices.data(), sizeof(NVGvertex) * _vertices.size());
+
+    _vertexBuffer->flushPersistentRange(sizeof(NVGvertex) * _vertexBase, sizeof(NVGvertex) * _vertices.size());
+}
 void NanoVGRenderer::renderCancel() {
     // Clear all data written by the render functions
     _vertices.clear();
-    _uniformAligner.resize(0);
+    _uniformAligner.reset();
     _drawCalls.clear();
     _paths.clear();
+    _usedLocalDescriptorSets = 0;
 }
 int NanoVGRenderer::createTexture(int type, int w, int h, int imageFlags, const unsigned char* data) {
     gli::format format;
@@ -669,19 +702,23 @@ std::unique_ptr<PipelineState> NanoVGRenderer::createPipelineState(const Pipelin
     return _renderer->createPipelineState(copy);
 }
 
-std::unique_ptr<DescriptorSet>
-NanoVGRenderer::createAndBindUniforms(CommandBuffer* cmd, size_t uniform_index, int image) {
+DescriptorSet* NanoVGRenderer::createAndBindUniforms(CommandBuffer* cmd, size_t uniform_index, int image) {
     auto tex = getTexture(image);
-    auto descriptor = _renderer->createDescriptorSet(DescriptorSetType::NanoVGLocalSet);
+
+    // The sets of the previous frames are reused since their contents are overwritten anyway
+    if (_usedLocalDescriptorSets == _localDescriptorSets.size()) {
+        _localDescriptorSets.push_back(_renderer->createDescriptorSet(DescriptorSetType::NanoVGLocalSet));
+    }
+    auto descriptor = _localDescriptorSets[_usedLocalDescriptorSets++].get();
+
     if (tex == nullptr) {
         descriptor->getDescriptor(DescriptorSetPart::NanoVGLocalSet_Texture)->setTexture(nullptr);
     } else {
         descriptor->getDescriptor(DescriptorSetPart::NanoVGLocalSet_Texture)->setTexture(tex->tex.get());
     }
+    auto uniforms = _uniformAligner.getElementRange(uniform_index);
     descriptor->getDescriptor(DescriptorSetPart::NanoVGLocalSet_Uniforms)->
-        setUniformBuffer(_uniformBuffer->buffer(),
-                         _uniformAligner.getOffset(uniform_index),
-                         sizeof(UniformData));
+        setUniformBuffer(uniforms.buffer, uniforms.offset, uniforms.size);
 
     cmd->bindDescriptorSet(descriptor);
 
@@ -691,47 +728,47 @@ NanoVGRenderer::createAndBindUniforms(CommandBuffer* cmd, size_t uniform_index,
 void NanoVGRenderer::drawTriangles(CommandBuffer* cmd, const DrawCall& call) {
     DEBUG_SCOPE(fillScope, _renderer->getDebugging(), "Draw triangles");
 
-    auto descriptor = createAndBindUniforms(cmd, call.uniformIndex, call.image);
+    createAndBindUniforms(cmd, call.uniformIndex, call.image);
 
     cmd->bindPipeline(_trianglesPipelineState);
 
-    cmd->draw(call.triangleCount, 1, call.triangleOffset, 0);
+    cmd->draw(call.triangleCount, 1, _vertexBase + call.triangleOffset, 0);
 }
 void NanoVGRenderer::drawFill(CommandBuffer* cmd, const DrawCall& call) {
     DEBUG_SCOPE(fillScope, _renderer->getDebugging(), "Draw fill");
 
-    auto shapeDescriptor = createAndBindUniforms(cmd, call.uniformIndex, 0);
+    createAndBindUniforms(cmd, call.uniformIndex, 0);
 
     cmd->bindPipeline(_fillShapePipelineState.get());
     auto pathOffset = call.pathOffset;
     for (size_t i = 0; i < call.pathCount; ++i) {
-        cmd->draw(_paths[pathOffset + i].fillCount, 1, _paths[pathOffset + i].fillOffset, 0);
+        cmd->draw(_paths[pathOffset + i].fillCount, 1, _vertexBase + _paths[pathOffset + i].fillOffset, 0);
     }
 
-    auto fillDescriptor = createAndBindUniforms(cmd, call.uniformIndex + 1, call.image);
+    createAndBindUniforms(cmd, call.uniformIndex + 1, call.image);
     cmd->bindPipeline(_fillAntiAliasPipelineState.get());
     // Draw fringes
     for (size_t i = 0; i < call.pathCount; ++i) {
-        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _paths[pathOffset + i].strokeOffset, 0);
+        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _vertexBase + _paths[pathOffset + i].strokeOffset, 0);
     }
 
     cmd->bindPipeline(_fillFillPipelineState.get());
-    cmd->draw(call.triangleCount, 1, call.triangleOffset, 0);
+    cmd->draw(call.triangleCount, 1, _vertexBase + call.triangleOffset, 0);
 }
 void NanoVGRenderer::drawConvexFill(CommandBuffer* cmd, const DrawCall& call) {
     DEBUG_SCOPE(fillScope, _renderer->getDebugging(), "Draw convex fill");
 
-    auto descriptor = createAndBindUniforms(cmd, call.uniformIndex, call.image);
+    createAndBindUniforms(cmd, call.uniformIndex, call.image);
 
     cmd->bindPipeline(_triangleFillPipelineState.get());
     auto pathOffset = call.pathOffset;
     for (size_t i = 0; i < call.pathCount; ++i) {
-        cmd->draw(_paths[pathOffset + i].fillCount, 1, _paths[pathOffset + i].fillOffset, 0);
+        cmd->draw(_paths[pathOffset + i].fillCount, 1, _vertexBase + _paths[pathOffset + i].fillOffset, 0);
     }
     cmd->bindPipeline(_triangleStrokePipelineState.get());
     // Draw fringes
     for (size_t i = 0; i < call.pathCount; ++i) {
-        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _paths[pathOffset + i].strokeOffset, 0);
+        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _vertexBase + _paths[pathOffset + i].strokeOffset, 0);
     }
 }
 void NanoVGRenderer::drawStroke(CommandBuffer* cmd, const DrawCall& call) {
@@ -741,21 +778,21 @@ void NanoVGRenderer::drawStroke(CommandBuffer* cmd, const DrawCall& call) {
 
     // Fill the stroke base without overlap
     cmd->bindPipeline(_strokeFillPipelineState.get());
-    auto fillDescriptor = createAndBindUniforms(cmd, call.uniformIndex + 1, call.image);
+    createAndBindUniforms(cmd, call.uniformIndex + 1, call.image);
     for (size_t i = 0; i < call.pathCount; ++i) {
-        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _paths[pathOffset + i].strokeOffset, 0);
+        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _vertexBase + _paths[pathOffset + i].strokeOffset, 0);
     }
 
     // Draw anti-aliased pixels.
     cmd->bindPipeline(_strokeAntiaiasPipelineState.get());
-    auto aaDescriptor = createAndBindUniforms(cmd, call.uniformIndex, call.image);
+    createAndBindUniforms(cmd, call.uniformIndex, call.image);
     for (size_t i = 0; i < call.pathCount; ++i) {
-        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _paths[pathOffset + i].strokeOffset, 0);
+        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _vertexBase + _paths[pathOffset + i].strokeOffset, 0);
     }
 
     // Clear stencil buffer.
     cmd->bindPipeline(_strokeClearStencilPipelineState.get());
     for (size_t i = 0; i < call.pathCount; ++i) {
-        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _paths[pathOffset + i].strokeOffset, 0);
+        cmd->draw(_paths[pathOffset + i].strokeCount, 1, _vertexBase + _paths[pathOffset + i].strokeOffset, 0);
     }
 }
@@ -4,8 +4,7 @@
 #include <renderer/Renderer.hpp>
 
 #include <unordered_map>
-#include <util/UniformAligner.hpp>
-#include <util/VariableUniformBuffer.hpp>
+#include <util/StreamingUniformAligner.hpp>
 
 NVGcontext* createNanoVGContext(Renderer* renderer);
 
@@ -71,14 +70,25 @@ class NanoVGRenderer
 
     Renderer* _renderer;
 
+    // The vertex buffer is persistently mapped and split into one segment per frame in flight. Every flush writes into
+    // the next segment so a segment is only overwritten once the GPU is done with it. NanoVG is flushed once per frame.
     std::unique_ptr<BufferObject> _vertexBuffer;
+    VertexInputStateProperties _vertexInput;
     std::unique_ptr<VertexArrayObject> _vertexArrayObject;
+    size_t _framesInFlight;
+    size_t _vertexSegmentCapacity;
+    size_t _currentVertexSegment;
+    size_t _vertexBase;
 
-    std::unique_ptr<VariableUniformBuffer> _uniformBuffer;
-    UniformAligner<UniformData, sizeof(GlobalUniformData)> _uniformAligner;
+    // The uniforms are written directly into streaming memory while the draw calls are added
+    StreamingUniformAligner<UniformData, sizeof(GlobalUniformData)> _uniformAligner;
 
     std::unique_ptr<DescriptorSet> _globalDescriptorSet;
 
+    // One set per draw call. These are kept across frames and reused.
+    std::vector<std::unique_ptr<DescriptorSet>> _localDescriptorSets;
+    size_t _usedLocalDescriptorSets;
+
 
     std::unique_ptr<PipelineState> _trianglesPipelineState;
     std::unique_ptr<PipelineState> _triangleFillPipelineState;
@@ -108,6 +118,9 @@ class NanoVGRenderer
     size_t addVertices(size_t num);
     size_t addPaths(size_t num);
 
+    void allocateVertexBuffer(size_t segmentCapacity);
+    void uploadVertices();
+
     bool convertPaint(UniformData* frag, NVGpaint* paint, NVGscissor* scissor, float width, float fringe, float strokeThr);
 
     Image* getTexture(int id);
@@ -116,7 +129,7 @@ class NanoVGRenderer
                                                        const VertexInputStateProperties& vertexProps,
                                                        PrimitiveType primitive);
 
-    std::unique_ptr<DescriptorSet> createAndBindUniforms(CommandBuffer* cmd, size_t uniform_index, int image);
+    DescriptorSet* createAndBindUniforms(CommandBuffer* cmd, size_t uniform_index, int image);
 
     void drawTriangles(CommandBuffer* cmd, const DrawCall& call);
     void drawFill(CommandBuffer* cmd, const DrawCall& call);
@@ -0,0 +1,89 @@
+//
+//
+
+#include "FreeListAllocator.hpp"
+#include "Assertion.hpp"
+
+#include <algorithm>
+
+FreeListAllocator::FreeListAllocator(size_t size) : _size(size), _freeSize(size) {
+    if (size > 0) {
+        FreeRange range;
+        range.offset = 0;
+        range.size = size;
+        _freeRanges.push_back(range);
+    }
+}
+
+size_t FreeListAllocator::allocate(size_t size, size_t alignment) {
+    Assertion(size > 0, "Size may not be zero!");
+    Assertion(alignment > 0, "Alignment may not be zero!");
+
+    for (auto it = _freeRanges.begin(); it != _freeRanges.end(); ++it) {
+        auto alignedOffset = (it->offset + alignment - 1) / alignment * alignment;
+        auto padding = alignedOffset - it->offset;
+
+        if (padding + size > it->size) {
+            continue;
+        }
+
+        auto rangeEnd = it->offset + it->size;
+        auto allocationEnd = alignedOffset + size;
+
+        // The padding in front of the allocation stays free so that free() only needs the offset and size which were
+        // handed out
+        if (padding > 0) {
+            it->size = padding;
+
+            if (allocationEnd < rangeEnd) {
+                FreeRange rest;
+                rest.offset = allocationEnd;
+                rest.size = rangeEnd - allocationEnd;
+                _freeRanges.insert(it + 1, rest);
+            }
+        } else if (allocationEnd < rangeEnd) {
+            it->offset = allocationEnd;
+            it->size = rangeEnd - allocationEnd;
+        } else {
+            _freeRanges.erase(it);
+        }
+
+        _freeSize -= size;
+        return alignedOffset;
+    }
+
+    return INVALID_OFFSET;
+}
+
+void FreeListAllocator::free(size_t offset, size_t size) {
+    Assertion(size > 0, "Size may not be zero!");
+    Assertion(offset + size <= _size, "Freed range is out of bounds!");
+
+    auto next = std::lower_bound(_freeRanges.begin(),
+                                 _freeRanges.end(),
+                                 offset,
+                                 [](const FreeRange& range, size_t value) { return range.offset < value; });
+
+    Assertion(next == _freeRanges.end() || offset + size <= next->offset, "Freed range overlaps a free range!");
+
+    _freeSize += size;
+
+    auto mergesWithPrevious = next != _freeRanges.begin() && (next - 1)->offset + (next - 1)->size == offset;
+    auto mergesWithNext = next != _freeRanges.end() && offset + size == next->offset;
+
+    if (mergesWithPrevious && mergesWithNext) {
+        auto previous = next - 1;
+        previous->size += size + next->size;
+        _freeRanges.erase(next);
+    } else if (mergesWithPrevious) {
+        (next - 1)->size += size;
+    } else if (mergesWithNext) {
+        next->offset = offset;
+        next->size += size;
+    } else {
+        FreeRange range;
+        range.offset = offset;
+        range.size = size;
+        _freeRanges.insert(next, range);
+    }
+}
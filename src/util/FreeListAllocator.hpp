@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hands out ranges of a linear block of memory with a fixed size. The allocator does not own any memory, it only
+// manages offsets. Free ranges are kept sorted by their offset so that neighbouring ranges can be merged again when an
+// allocation is freed. Allocations use the first free range which is large enough.
+class FreeListAllocator {
+ public:
+    static const size_t INVALID_OFFSET = SIZE_MAX;
+
+ private:
+    struct FreeRange {
+        size_t offset;
+        size_t size;
+    };
+
+    size_t _size;
+    size_t _freeSize;
+
+    std::vector<FreeRange> _freeRanges;
+ public:
+    explicit FreeListAllocator(size_t size);
+
+    // The alignment does not have to be a power of two. Returns INVALID_OFFSET if no free range is large enough.
+    size_t allocate(size_t size, size_t alignment);
+
+    // The size has to be the same that was passed to allocate
+    void free(size_t offset, size_t size);
+
+    size_t getSize() const {
+        return _size;
+    }
+
+    size_t getFreeSize() const {
+        return _freeSize;
+    }
+};
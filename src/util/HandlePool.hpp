@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Assertion.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// A 32-bit reference into a HandlePool. The lower bits are the index of the slot and the upper bits are the generation
+// of that slot when the handle was created. A slot gets a new generation when its object is destroyed so old handles
+// to that slot can be detected. The tag type keeps handles of different pools apart.
+template<typename Tag>
+class Handle {
+    uint32_t _value;
+
+    explicit Handle(uint32_t value) : _value(value) { }
+ public:
+    static const uint32_t INDEX_BITS = 20;
+    static const uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+
+    static const uint32_t MAX_INDEX = (1u << INDEX_BITS) - 1;
+    static const uint32_t MAX_GENERATION = (1u << GENERATION_BITS) - 1;
+
+    // Generation 0 is never used by a pool so the default handle is never valid
+    Handle() : _value(0) { }
+
+    static Handle fromParts(uint32_t index, uint32_t generation) {
+        return Handle((generation << INDEX_BITS) | index);
+    }
+
+    uint32_t getIndex() const {
+        return _value & MAX_INDEX;
+    }
+
+    uint32_t getGeneration() const {
+        return _value >> INDEX_BITS;
+    }
+
+    uint32_t getValue() const {
+        return _value;
+    }
+
+    explicit operator bool() const {
+        return _value != 0;
+    }
+
+    friend bool operator==(Handle a, Handle b) { return a._value == b._value; }
+    friend bool operator!=(Handle a, Handle b) { return a._value != b._value; }
+};
+
+// Stores objects by value in one contiguous array and hands out generational handles for them. Destroyed slots are
+// reused by later create calls. Pointers returned by get() are only valid until the next call to create() since the
+// storage may be reallocated, handles stay valid until the object is destroyed.
+//
+// T needs to be default constructible and move assignable. Destroying an object assigns a default constructed object
+// to its slot.
+template<typename T, typename Tag = T>
+class HandlePool {
+ public:
+    typedef Handle<Tag> handle_type;
+
+ private:
+    std::vector<T> _objects;
+    std::vector<uint32_t> _generations;
+    std::vector<uint32_t> _freeSlots;
+
+    size_t _size;
+ public:
+    HandlePool() : _size(0) { }
+
+    template<typename... Args>
+    handle_type create(Args&& ... args) {
+        uint32_t index;
+        if (!_freeSlots.empty()) {
+            index = _freeSlots.back();
+            _freeSlots.pop_back();
+
+            _objects[index] = T(std::forward<Args>(args)...);
+        } else {
+            Assertion(_objects.size() <= handle_type::MAX_INDEX, "Handle pool is full!");
+
+            index = static_cast<uint32_t>(_objects.size());
+            _objects.emplace_back(std::forward<Args>(args)...);
+            _generations.push_back(1);
+        }
+
+        ++_size;
+        return handle_type::fromParts(index, _generations[index]);
+    }
+
+    void destroy(handle_type handle) {
+        Assertion(isValid(handle), "Tried to destroy an invalid or stale handle!");
+
+        auto index = handle.getIndex();
+        _objects[index] = T();
+
+        auto& generation = _generations[index];
+        generation = generation == handle_type::MAX_GENERATION ? 1 : generation + 1;
+
+        _freeSlots.push_back(index);
+        --_size;
+    }
+
+    bool isValid(handle_type handle) const {
+        auto index = handle.getIndex();
+        return index < _generations.size() && _generations[index] == handle.getGeneration();
+    }
+
+    // The generation check is an assertion so it is only done in debug builds
+    T* get(handle_type handle) {
+        Assertion(isValid(handle), "Tried to access an invalid or stale handle!");
+        return &_objects[handle.getIndex()];
+    }
+
+    const T* get(handle_type handle) const {
+        Assertion(isValid(handle), "Tried to access an invalid or stale handle!");
+        return &_objects[handle.getIndex()];
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    void clear() {
+        _objects.clear();
+        _generations.clear();
+        _freeSlots.clear();
+        _size = 0;
+    }
+};
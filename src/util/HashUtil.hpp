@@ -1,7 +1,9 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include <functional>
+#include <type_traits>
 
 namespace std {
     template<typename T, typename U>
@@ -26,3 +28,26 @@ public:
 
 #define HASHABLE_ENUMCLASS(TYPE) namespace std{template<> struct hash<TYPE> : EnumClassHash<TYPE> {};}
 
+// Mixes the hash of value into seed. Used for building the hash of a structure from the hashes of its members.
+template<typename T>
+inline typename std::enable_if<!std::is_enum<T>::value>::type hash_combine(size_t& seed, const T& value) {
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_enum<T>::value>::type hash_combine(size_t& seed, const T& value) {
+    seed ^= EnumClassHash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// 64-bit FNV-1a hash of the bytes. Unlike std::hash the result is the same on every platform and every run so it may be
+// stored in files. Pass the result of a previous call as hash to continue hashing.
+const uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+
+inline uint64_t hash_fnv1a(const void* data, size_t size, uint64_t hash = FNV1A_OFFSET_BASIS) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
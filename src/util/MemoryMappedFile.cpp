@@ -0,0 +1,134 @@
+//
+//
+
+#include "MemoryMappedFile.hpp"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef WIN32
+MemoryMappedFile::MemoryMappedFile()
+    : _data(nullptr), _size(0), _open(false), _fileHandle(INVALID_HANDLE_VALUE), _mappingHandle(nullptr) {
+}
+#else
+MemoryMappedFile::MemoryMappedFile() : _data(nullptr), _size(0), _open(false), _fileDescriptor(-1) {
+}
+#endif
+
+MemoryMappedFile::~MemoryMappedFile() {
+    close();
+}
+
+#ifdef WIN32
+bool MemoryMappedFile::open(const std::string& path) {
+    close();
+
+    _fileHandle = CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(_fileHandle, &fileSize)) {
+        close();
+        return false;
+    }
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    _open = true;
+
+    if (_size == 0) {
+        // Empty files can't be mapped
+        return true;
+    }
+
+    _mappingHandle = CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MemoryMappedFile::close() {
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+    }
+    if (_mappingHandle != nullptr) {
+        CloseHandle(_mappingHandle);
+        _mappingHandle = nullptr;
+    }
+    if (_fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(_fileHandle);
+        _fileHandle = INVALID_HANDLE_VALUE;
+    }
+    _size = 0;
+    _open = false;
+}
+#else
+bool MemoryMappedFile::open(const std::string& path) {
+    close();
+
+    _fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (_fileDescriptor < 0) {
+        return false;
+    }
+
+    struct stat fileInfo;
+    if (fstat(_fileDescriptor, &fileInfo) != 0) {
+        close();
+        return false;
+    }
+    _size = static_cast<size_t>(fileInfo.st_size);
+    _open = true;
+
+    if (_size == 0) {
+        // Empty files can't be mapped
+        return true;
+    }
+
+    auto mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+    _data = static_cast<const uint8_t*>(mapping);
+
+    // Most of the file is read once from front to back so aggressive read-ahead is beneficial
+    madvise(mapping, _size, MADV_SEQUENTIAL);
+
+    return true;
+}
+
+void MemoryMappedFile::close() {
+    if (_data != nullptr) {
+        munmap(const_cast<uint8_t*>(_data), _size);
+        _data = nullptr;
+    }
+    if (_fileDescriptor >= 0) {
+        ::close(_fileDescriptor);
+        _fileDescriptor = -1;
+    }
+    _size = 0;
+    _open = false;
+}
+#endif
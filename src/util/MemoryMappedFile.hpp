@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Maps a whole file read-only into the address space of the process. The contents are only read from disk when they
+// are accessed and no copy is kept on the heap, so large files can be processed without loading them first. Pointers
+// into the data are valid until the file is closed.
+class MemoryMappedFile {
+    const uint8_t* _data;
+    size_t _size;
+    bool _open;
+
+#ifdef WIN32
+    void* _fileHandle;
+    void* _mappingHandle;
+#else
+    int _fileDescriptor;
+#endif
+ public:
+    MemoryMappedFile();
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    // Returns false if the file could not be opened or mapped. An empty file is valid but has no data pointer.
+    bool open(const std::string& path);
+
+    void close();
+
+    bool isOpen() const {
+        return _open;
+    }
+
+    const uint8_t* getData() const {
+        return _data;
+    }
+
+    size_t getSize() const {
+        return _size;
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <renderer/Renderer.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Assertion.hpp"
+
+// Places uniform elements at the alignment required by the renderer. The elements are written directly into the
+// streaming uniform memory of the renderer so the data does not have to be copied to the GPU afterwards. The memory is
+// allocated in chunks. When a chunk is full a new, larger chunk is allocated and the existing elements stay where they
+// are. Elements of one frame may therefore be in different buffers so the range of each element has to be queried
+// separately. The number of elements of the previous frame is used for the first chunk so usually there is only one
+// chunk per frame.
+//
+// The memory is not cleared and may only be written. Reading it back can be very slow.
+template<typename TData, size_t HeaderSize = 0>
+class StreamingUniformAligner {
+ private:
+    static const size_t MIN_CHUNK_ELEMENTS = 16;
+
+    struct Chunk {
+        StreamingUniformAllocation allocation;
+        size_t first_element;
+        size_t capacity;
+
+        // Offset of the first element in the chunk, only the first chunk contains the header
+        size_t element_offset;
+    };
+
+    Renderer* _renderer;
+
+    size_t _headerSize;
+    size_t _elementSize;
+
+    std::vector<Chunk> _chunks;
+    size_t _capacity;
+    size_t _numElements;
+
+    size_t _reservedElements;
+
+    static size_t alignSize(size_t size, size_t align) {
+        if (align == 0) {
+            return size;
+        }
+
+        auto remainder = size % align;
+        if (remainder == 0) {
+            return size;
+        }
+
+        return size + align - remainder;
+    }
+
+    void addChunk(size_t minElements) {
+        Chunk chunk;
+        chunk.first_element = _capacity;
+        chunk.element_offset = _chunks.empty() ? _headerSize : 0;
+
+        if (_chunks.empty()) {
+            chunk.capacity = std::max(minElements, _reservedElements);
+            if (chunk.capacity < MIN_CHUNK_ELEMENTS) {
+                chunk.capacity = MIN_CHUNK_ELEMENTS;
+            }
+        } else {
+            // Double the capacity every time the memory runs out
+            chunk.capacity = std::max(minElements, _capacity);
+        }
+
+        chunk.allocation = _renderer->allocateStreamingUniforms(chunk.element_offset + chunk.capacity * _elementSize);
+
+        _capacity += chunk.capacity;
+        _chunks.push_back(chunk);
+    }
+
+    void ensureCapacity(size_t num_elements) {
+        if (_chunks.empty()) {
+            // The header is always in the first chunk
+            addChunk(num_elements);
+        }
+        if (num_elements > _capacity) {
+            addChunk(num_elements - _capacity);
+        }
+    }
+
+    const Chunk& findChunk(size_t index) const {
+        Assertion(index < _numElements, "Invalid index specified!");
+
+        // There are only very few chunks and the last one contains most elements
+        for (auto it = _chunks.rbegin(); it != _chunks.rend(); ++it) {
+            if (index >= it->first_element) {
+                return *it;
+            }
+        }
+        return _chunks.front();
+    }
+ public:
+    StreamingUniformAligner(Renderer* renderer, size_t requiredAlignment)
+        : _renderer(renderer), _headerSize(alignSize(HeaderSize, requiredAlignment)),
+          _elementSize(alignSize(sizeof(TData), requiredAlignment)), _capacity(0), _numElements(0),
+          _reservedElements(0) {
+    }
+
+    // Discards the elements of the previous frame. Ranges that were returned before are not valid anymore.
+    void reset() {
+        if (_numElements > 0) {
+            _reservedElements = _numElements;
+        }
+
+        _chunks.clear();
+        _capacity = 0;
+        _numElements = 0;
+    }
+
+    void resize(size_t num_elements) {
+        Assertion(num_elements >= _numElements, "Streaming uniform data can not shrink, use reset() instead!");
+
+        ensureCapacity(num_elements);
+        _numElements = num_elements;
+    }
+
+    TData* addElement() {
+        resize(_numElements + 1);
+
+        return getElement(_numElements - 1);
+    }
+
+    template<typename THeader>
+    THeader* getHeader() {
+        static_assert(sizeof(THeader) == HeaderSize, "Header size does not match requested header type!");
+
+        ensureCapacity(0);
+
+        return static_cast<THeader*>(_chunks.front().allocation.data);
+    }
+
+    TData* getElement(size_t index) {
+        auto& chunk = findChunk(index);
+
+        auto offset = chunk.element_offset + _elementSize * (index - chunk.first_element);
+        return reinterpret_cast<TData*>(static_cast<uint8_t*>(chunk.allocation.data) + offset);
+    }
+
+    UniformBufferRange getHeaderRange() const {
+        Assertion(!_chunks.empty(), "Header has not been written yet!");
+
+        UniformBufferRange range = _chunks.front().allocation.range;
+        range.size = HeaderSize;
+        return range;
+    }
+
+    UniformBufferRange getElementRange(size_t index) const {
+        auto& chunk = findChunk(index);
+
+        UniformBufferRange range = chunk.allocation.range;
+        range.offset += chunk.element_offset + _elementSize * (index - chunk.first_element);
+        range.size = sizeof(TData);
+        return range;
+    }
+
+    // Makes the written data visible to the GPU. Has to be called after all elements were written and before they are
+    // used for drawing. The ranges stay valid until reset() is called.
+    void finish() {
+        for (auto& chunk : _chunks) {
+            auto usedElements = std::min(chunk.capacity, _numElements - std::min(_numElements, chunk.first_element));
+
+            UniformBufferRange range = chunk.allocation.range;
+            range.size = chunk.element_offset + usedElements * _elementSize;
+
+            if (range.size > 0) {
+                _renderer->commitStreamingUniforms(range);
+            }
+        }
+    }
+
+    size_t getNumElements() const {
+        return _numElements;
+    }
+};
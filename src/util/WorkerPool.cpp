@@ -0,0 +1,144 @@
+//
+//
+
+#include "WorkerPool.hpp"
+
+#include "Assertion.hpp"
+
+#include <algorithm>
+
+WorkerPool::JobGroup::JobGroup() : _remaining(0) {
+}
+
+WorkerPool::JobGroup::~JobGroup() {
+    Assertion(_remaining == 0, "Job group was destroyed while it still had unfinished jobs!");
+}
+
+void WorkerPool::JobGroup::add() {
+    std::lock_guard<std::mutex> guard(_lock);
+    ++_remaining;
+}
+
+void WorkerPool::JobGroup::finish() {
+    // Notifying while the lock is held ensures that the group is not destroyed by a returning wait before that
+    std::lock_guard<std::mutex> guard(_lock);
+    --_remaining;
+    if (_remaining == 0) {
+        _finished.notify_all();
+    }
+}
+
+void WorkerPool::JobGroup::wait() {
+    std::unique_lock<std::mutex> lock(_lock);
+    _finished.wait(lock, [this]() { return _remaining == 0; });
+}
+
+WorkerPool::Job::Job() : _next(nullptr), _group(nullptr), _ownedByPool(false) {
+}
+
+WorkerPool::Job::~Job() {
+}
+
+size_t WorkerPool::getDefaultThreadCount() {
+    // hardware_concurrency may return 0 if the number of cores can not be determined
+    auto cores = static_cast<size_t>(std::thread::hardware_concurrency());
+    return std::max(cores, (size_t) 2) - 1;
+}
+
+WorkerPool::WorkerPool(size_t numThreads) : _firstJob(nullptr), _lastJob(nullptr), _stopping(false) {
+    Assertion(numThreads > 0, "A worker pool needs at least one thread!");
+
+    _threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        _threads.emplace_back(&WorkerPool::workerMain, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    Job* discarded;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stopping = true;
+
+        discarded = _firstJob;
+        _firstJob = nullptr;
+        _lastJob = nullptr;
+    }
+    _jobAvailable.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+
+    while (discarded != nullptr) {
+        auto next = discarded->_next;
+        completeJob(discarded, discarded->_group, discarded->_ownedByPool);
+        discarded = next;
+    }
+}
+
+void WorkerPool::submit(Job* job, JobGroup* group) {
+    Assertion(job != nullptr, "Job may not be null!");
+
+    enqueue(job, group, false);
+}
+
+void WorkerPool::enqueue(Job* job, JobGroup* group, bool ownedByPool) {
+    if (group != nullptr) {
+        group->add();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        Assertion(!_stopping, "Jobs can not be submitted while the pool is destroyed!");
+
+        job->_next = nullptr;
+        job->_group = group;
+        job->_ownedByPool = ownedByPool;
+
+        if (_lastJob == nullptr) {
+            _firstJob = job;
+        } else {
+            _lastJob->_next = job;
+        }
+        _lastJob = job;
+    }
+    _jobAvailable.notify_one();
+}
+
+void WorkerPool::completeJob(Job* job, JobGroup* group, bool ownedByPool) {
+    if (ownedByPool) {
+        delete job;
+    }
+    if (group != nullptr) {
+        group->finish();
+    }
+}
+
+void WorkerPool::workerMain() {
+    while (true) {
+        Job* job;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _jobAvailable.wait(lock, [this]() { return _stopping || _firstJob != nullptr; });
+
+            if (_stopping) {
+                return;
+            }
+
+            job = _firstJob;
+            _firstJob = job->_next;
+            if (_firstJob == nullptr) {
+                _lastJob = nullptr;
+            }
+        }
+
+        // Jobs of the caller may be reused as soon as their group is finished so they are not accessed after executing
+        auto group = job->_group;
+        auto ownedByPool = job->_ownedByPool;
+
+        job->execute();
+
+        completeJob(job, group, ownedByPool);
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads which is started once and executes jobs from a shared queue in the order they were submitted.
+// This avoids creating a new thread for every job which is expensive if jobs are submitted every frame.
+//
+// Jobs are linked into the queue directly so submitting a job which is owned by the caller does not allocate. Work
+// which is done every frame should use such jobs and wait for them with a job group. submit with a function is more
+// convenient but allocates the job and the shared state of its future.
+//
+// Jobs which have not been started when the pool is destroyed are discarded, their groups are finished and the futures
+// of functions report a broken promise. Jobs may be submitted from any thread.
+class WorkerPool {
+ public:
+    // Counts the unfinished jobs which were submitted with it so the submitter can wait for all of them at once
+    class JobGroup {
+        friend class WorkerPool;
+
+        std::mutex _lock;
+        std::condition_variable _finished;
+        size_t _remaining;
+
+        void add();
+
+        void finish();
+     public:
+        JobGroup();
+        ~JobGroup();
+
+        JobGroup(const JobGroup&) = delete;
+        JobGroup& operator=(const JobGroup&) = delete;
+
+        // Blocks until all jobs of the group have been executed
+        void wait();
+    };
+
+    // A job which is owned by the caller. It must stay alive until it was executed and may be submitted again after
+    // that, e.g. once the wait of its group returned.
+    class Job {
+        friend class WorkerPool;
+
+        Job* _next;
+        JobGroup* _group;
+        bool _ownedByPool;
+     public:
+        Job();
+        virtual ~Job();
+
+        virtual void execute() = 0;
+    };
+
+ private:
+    template<typename TResult>
+    class TaskJob final: public Job {
+        std::packaged_task<TResult()> _task;
+     public:
+        template<typename TFunc>
+        explicit TaskJob(TFunc&& func) : _task(std::forward<TFunc>(func)) {
+        }
+
+        std::future<TResult> getFuture() {
+            return _task.get_future();
+        }
+
+        void execute() override {
+            _task();
+        }
+    };
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _lock;
+    std::condition_variable _jobAvailable;
+    Job* _firstJob;
+    Job* _lastJob;
+    bool _stopping;
+
+    void workerMain();
+
+    void enqueue(Job* job, JobGroup* group, bool ownedByPool);
+
+    static void completeJob(Job* job, JobGroup* group, bool ownedByPool);
+ public:
+    // One thread per core except for the one of the render thread
+    static size_t getDefaultThreadCount();
+
+    explicit WorkerPool(size_t numThreads = getDefaultThreadCount());
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t getNumThreads() const {
+        return _threads.size();
+    }
+
+    // The group is optional, if it is specified it must outlive the execution of the job
+    void submit(Job* job, JobGroup* group);
+
+    template<typename TFunc>
+    std::future<typename std::result_of<TFunc()>::type> submit(TFunc&& func) {
+        typedef typename std::result_of<TFunc()>::type TResult;
+
+        auto job = new TaskJob<TResult>(std::forward<TFunc>(func));
+        auto future = job->getFuture();
+
+        enqueue(job, nullptr, true);
+
+        return future;
+    }
+};
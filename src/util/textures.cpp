@@ -10,39 +10,54 @@
 
 #include "util/stb_image.h"
 
-std::unique_ptr<Texture> util::load_texture(Renderer* renderer, const std::string& path) {
-
-    auto render_texture = renderer->createTexture();
+std::unique_ptr<gli::texture> util::decode_texture(const std::string& path) {
     int width, height, components;
     auto texture_data = stbi_load(path.c_str(), &width, &height, &components, 0);
-    if (texture_data) {
-        auto stride = width * components;
-        std::unique_ptr<uint8_t[]> buffer(new uint8_t[stride]);
-        size_t height_half = width / 2;
-        for (size_t y = 0; y < height_half; ++y) {
-            uint8_t* top = texture_data + y * stride;
-            uint8_t* bottom = texture_data + (height - y - 1) * stride;
-
-            memcpy(buffer.get(), top, stride);
-            memcpy(top, bottom, stride);
-            memcpy(bottom, buffer.get(), stride);
-        }
-        auto format = components == 3 ? gli::format::FORMAT_RGB8_UNORM_PACK8 : gli::format::FORMAT_RGBA8_UNORM_PACK8;
-        gli::texture2d texture(format, gli::extent2d(width, height), 1);
+    if (!texture_data) {
+        return nullptr;
+    }
 
-        std::memcpy(texture.data(), texture_data, texture.size());
+    auto stride = width * components;
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[stride]);
+    size_t height_half = width / 2;
+    for (size_t y = 0; y < height_half; ++y) {
+        uint8_t* top = texture_data + y * stride;
+        uint8_t* bottom = texture_data + (height - y - 1) * stride;
 
-        auto mipmaped = gli::generate_mipmaps(texture, gli::FILTER_LINEAR);
+        memcpy(buffer.get(), top, stride);
+        memcpy(top, bottom, stride);
+        memcpy(bottom, buffer.get(), stride);
+    }
+    auto format = components == 3 ? gli::format::FORMAT_RGB8_UNORM_PACK8 : gli::format::FORMAT_RGBA8_UNORM_PACK8;
+    gli::texture2d texture(format, gli::extent2d(width, height), 1);
+
+    std::memcpy(texture.data(), texture_data, texture.size());
+    stbi_image_free(texture_data);
 
-        FilterProperties props;
-        props.magnification_filter = FilterMode::Linear;
-        props.minification_filter = FilterMode::LinearMipmapLinear;
+    return std::unique_ptr<gli::texture>(new gli::texture(gli::generate_mipmaps(texture, gli::FILTER_LINEAR)));
+}
 
-        render_texture->initialize(mipmaped, props);
+FilterProperties util::get_texture_filter_properties() {
+    FilterProperties props;
+    props.magnification_filter = FilterMode::Linear;
+    props.minification_filter = FilterMode::LinearMipmapLinear;
 
-        stbi_image_free(texture_data);
+    return props;
+}
+
+std::unique_ptr<Texture> util::load_texture(Renderer* renderer, const std::string& path, UploadQueue* uploads) {
+
+    auto render_texture = renderer->createTexture();
+    render_texture->setDebugName(path);
+
+    auto texture = decode_texture(path);
+    if (texture) {
+        if (uploads != nullptr) {
+            uploads->uploadTexture(render_texture.get(), *texture, get_texture_filter_properties());
+        } else {
+            render_texture->initialize(*texture, get_texture_filter_properties());
+        }
     }
 
     return render_texture;
 }
-
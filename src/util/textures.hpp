@@ -3,8 +3,19 @@
 #include "renderer/Renderer.hpp"
 #include "renderer/Texture.hpp"
 
+#include <gli/texture.hpp>
+
 #include <memory>
 
 namespace util {
-    std::unique_ptr<Texture> load_texture(Renderer* renderer, const std::string& path);
+    // Reads the image and generates the mipmaps of it. Returns nullptr if the image could not be read. This does not
+    // use the renderer so it may be called from any thread.
+    std::unique_ptr<gli::texture> decode_texture(const std::string& path);
+
+    // The filter properties of textures created from decode_texture
+    FilterProperties get_texture_filter_properties();
+
+    // If an upload queue is specified the texture data is uploaded through it and the texture is only usable once the
+    // upload is complete
+    std::unique_ptr<Texture> load_texture(Renderer* renderer, const std::string& path, UploadQueue* uploads = nullptr);
 }